@@ -0,0 +1,162 @@
+#pragma once
+
+#include "ofVec3f.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+// Octree over weighted points for approximate all-pairs repulsion. Built top-down by partitioning an
+// index array into octants; queries are read-only, so any number of threads may run them at once.
+class BarnesHutTree
+{
+	struct Cell
+	{
+		ofVec3f mCenterOfMass;
+		float mMass = 0;
+		float mSize = 0;
+		int mFirst = 0;
+		int mLast = 0;
+		bool mLeaf = true;
+		std::array<int, 8> mChildren;
+	};
+
+public:
+	static constexpr int kLeafSize = 8;
+	static constexpr int kMaxDepth = 24;
+
+	void build(const std::vector<ofVec3f> &positions, const std::vector<float> &masses)
+	{
+		mPositions = &positions;
+		mMasses = &masses;
+		mCells.clear();
+		mIndices.resize(positions.size());
+		std::iota(mIndices.begin(), mIndices.end(), 0);
+		if (positions.empty())
+		{
+			return;
+		}
+
+		auto lower = positions[0];
+		auto upper = positions[0];
+		for (const auto &position : positions)
+		{
+			for (auto axis = 0; axis < 3; ++axis)
+			{
+				lower[axis] = std::min(lower[axis], position[axis]);
+				upper[axis] = std::max(upper[axis], position[axis]);
+			}
+		}
+		auto size = std::max({upper.x - lower.x, upper.y - lower.y, upper.z - lower.z, 1e-3f});
+		buildCell(0, static_cast<int>(positions.size()), (lower + upper) * 0.5f, size, 0);
+	}
+
+	// Sum over points j != self of strength * mass * mass_j * (position - p_j) / |position - p_j|^2,
+	// using a cell's centre of mass whenever cell size / distance < theta.
+	ofVec3f repulsion(const ofVec3f &position, float mass, int self, float strength, float theta) const
+	{
+		ofVec3f force;
+		if (mCells.empty())
+		{
+			return force;
+		}
+
+		auto thetaSquared = theta * theta;
+		int stack[8 * kMaxDepth + 8];
+		auto top = 0;
+		stack[top++] = 0;
+		while (top > 0)
+		{
+			const auto &cell = mCells[stack[--top]];
+			auto delta = position - cell.mCenterOfMass;
+			auto distanceSquared = delta.lengthSquared();
+			if (!cell.mLeaf && cell.mSize * cell.mSize < thetaSquared * distanceSquared)
+			{
+				force += delta * (strength * mass * cell.mMass / std::max(distanceSquared, 1e-6f));
+				continue;
+			}
+			if (cell.mLeaf)
+			{
+				for (auto i = cell.mFirst; i < cell.mLast; ++i)
+				{
+					auto j = mIndices[i];
+					if (j != self)
+					{
+						auto pointDelta = position - (*mPositions)[j];
+						force += pointDelta * (strength * mass * (*mMasses)[j] / std::max(pointDelta.lengthSquared(), 1e-6f));
+					}
+				}
+				continue;
+			}
+			for (auto child : cell.mChildren)
+			{
+				if (child >= 0)
+				{
+					stack[top++] = child;
+				}
+			}
+		}
+		return force;
+	}
+
+private:
+	int buildCell(int first, int last, ofVec3f center, float size, int depth)
+	{
+		auto index = static_cast<int>(mCells.size());
+		mCells.emplace_back();
+		mCells[index].mSize = size;
+		mCells[index].mFirst = first;
+		mCells[index].mLast = last;
+		mCells[index].mChildren.fill(-1);
+
+		ofVec3f weighted;
+		auto mass = 0.0f;
+		for (auto i = first; i < last; ++i)
+		{
+			weighted += (*mPositions)[mIndices[i]] * (*mMasses)[mIndices[i]];
+			mass += (*mMasses)[mIndices[i]];
+		}
+		mCells[index].mMass = mass;
+		mCells[index].mCenterOfMass = mass > 0 ? weighted / mass : center;
+
+		if (last - first <= kLeafSize || depth == kMaxDepth)
+		{
+			return index;
+		}
+
+		mCells[index].mLeaf = false;
+
+		// Split [first, last) into eight octants: by x, then y within each half, then z.
+		const auto &positions = *mPositions;
+		std::array<int, 9> bounds;
+		bounds[0] = first;
+		bounds[8] = last;
+		auto begin = mIndices.begin();
+		bounds[4] = std::partition(begin + first, begin + last, [&](int i) { return positions[i].x < center.x; }) - begin;
+		for (auto half = 0; half < 2; ++half)
+		{
+			bounds[2 + 4 * half] = std::partition(begin + bounds[4 * half], begin + bounds[4 * half + 4], [&](int i) { return positions[i].y < center.y; }) - begin;
+			for (auto quarter = 0; quarter < 2; ++quarter)
+			{
+				auto low = 4 * half + 2 * quarter;
+				bounds[low + 1] = std::partition(begin + bounds[low], begin + bounds[low + 2], [&](int i) { return positions[i].z < center.z; }) - begin;
+			}
+		}
+
+		for (auto octant = 0; octant < 8; ++octant)
+		{
+			if (bounds[octant] < bounds[octant + 1])
+			{
+				auto offset = ofVec3f(octant & 4 ? 0.25f : -0.25f, octant & 2 ? 0.25f : -0.25f, octant & 1 ? 0.25f : -0.25f) * size;
+				auto child = buildCell(bounds[octant], bounds[octant + 1], center + offset, size * 0.5f, depth + 1);
+				mCells[index].mChildren[octant] = child;
+			}
+		}
+		return index;
+	}
+
+	const std::vector<ofVec3f> *mPositions = nullptr;
+	const std::vector<float> *mMasses = nullptr;
+	std::vector<Cell> mCells;
+	std::vector<int> mIndices;
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Direction-optimising BFS (Beamer et al.). Top-down levels expand a queue frontier in parallel and
+// claim nodes with CAS; once the frontier's edges exceed unexplored edges / alpha it switches to
+// bottom-up levels, where every unvisited node scans its neighbours against a bitmap frontier, and
+// back again when the frontier shrinks below n / beta. The arcs of every discovered node, in either
+// direction, are taken off the unexplored count. Returns hop distances, -1 when unreachable.
+inline std::vector<int> breadthFirstSearch(const CsrGraph &graph, int source, int alpha = 15, int beta = 18)
+{
+	auto numNodes = graph.numNodes();
+	auto numWords = (static_cast<std::size_t>(numNodes) + 63) / 64;
+	std::unique_ptr<std::atomic<int>[]> distances(new std::atomic<int>[numNodes]);
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		distances[i].store(-1, std::memory_order_relaxed);
+	}
+	distances[source] = 0;
+
+	auto threads = numThreads();
+	std::vector<int> frontier = {source};
+	std::vector<std::vector<int>> nextFrontiers(threads);
+	std::vector<std::uint64_t> bitmap(numWords, 0);
+	std::vector<std::uint64_t> nextBitmap(numWords, 0);
+	std::vector<std::size_t> counts(threads);
+	std::vector<std::int64_t> arcs(threads);
+
+	std::int64_t frontierArcs = graph.degree(source);
+	auto unexploredArcs = static_cast<std::int64_t>(graph.numArcs()) - frontierArcs;
+	auto bottomUp = false;
+	std::size_t frontierSize = 1;
+	for (auto level = 0; frontierSize > 0; ++level)
+	{
+		if (!bottomUp)
+		{
+			if (frontierArcs > unexploredArcs / alpha)
+			{
+				std::fill(bitmap.begin(), bitmap.end(), 0);
+				for (auto u : frontier)
+				{
+					bitmap[u / 64] |= std::uint64_t(1) << (u % 64);
+				}
+				bottomUp = true;
+			}
+		}
+		else if (frontierSize < static_cast<std::size_t>(numNodes / beta))
+		{
+			frontier.clear();
+			for (std::size_t word = 0; word < numWords; ++word)
+			{
+				for (auto bits = bitmap[word]; bits; bits &= bits - 1)
+				{
+					frontier.push_back(static_cast<int>(word * 64 + __builtin_ctzll(bits)));
+				}
+			}
+			bottomUp = false;
+		}
+
+		if (bottomUp)
+		{
+			// Threads own whole bitmap words, so the next bitmap needs no atomics.
+			parallelRanges(numWords, [&](int thread, std::size_t first, std::size_t last) {
+				std::size_t count = 0;
+				std::int64_t discoveredArcs = 0;
+				for (auto word = first; word < last; ++word)
+				{
+					std::uint64_t bits = 0;
+					auto end = std::min<std::size_t>((word + 1) * 64, numNodes);
+					for (auto v = word * 64; v < end; ++v)
+					{
+						if (distances[v].load(std::memory_order_relaxed) >= 0)
+						{
+							continue;
+						}
+						for (auto u = graph.begin(v); u != graph.end(v); ++u)
+						{
+							if (bitmap[*u / 64] >> (*u % 64) & 1)
+							{
+								distances[v].store(level + 1, std::memory_order_relaxed);
+								bits |= std::uint64_t(1) << (v % 64);
+								++count;
+								discoveredArcs += graph.degree(static_cast<int>(v));
+								break;
+							}
+						}
+					}
+					nextBitmap[word] = bits;
+				}
+				counts[thread] = count;
+				arcs[thread] = discoveredArcs;
+			}, threads);
+			bitmap.swap(nextBitmap);
+		}
+		else
+		{
+			for (auto &next : nextFrontiers)
+			{
+				next.clear();
+			}
+			parallelRanges(frontier.size(), [&](int thread, std::size_t first, std::size_t last) {
+				auto &next = nextFrontiers[thread];
+				std::int64_t discoveredArcs = 0;
+				for (auto i = first; i < last; ++i)
+				{
+					auto u = frontier[i];
+					for (auto v = graph.begin(u); v != graph.end(u); ++v)
+					{
+						auto unvisited = -1;
+						if (distances[*v].load(std::memory_order_relaxed) < 0 &&
+							distances[*v].compare_exchange_strong(unvisited, level + 1, std::memory_order_relaxed))
+						{
+							next.push_back(*v);
+							discoveredArcs += graph.degree(*v);
+						}
+					}
+				}
+				counts[thread] = next.size();
+				arcs[thread] = discoveredArcs;
+			}, threads);
+			frontier.clear();
+			for (auto &next : nextFrontiers)
+			{
+				frontier.insert(frontier.end(), next.begin(), next.end());
+			}
+		}
+
+		frontierSize = 0;
+		frontierArcs = 0;
+		for (auto thread = 0; thread < threads; ++thread)
+		{
+			frontierSize += counts[thread];
+			frontierArcs += arcs[thread];
+			counts[thread] = 0;
+			arcs[thread] = 0;
+		}
+		unexploredArcs -= frontierArcs;
+	}
+
+	std::vector<int> result(numNodes);
+	parallelFor(numNodes, [&](std::size_t i) { result[i] = distances[i].load(std::memory_order_relaxed); });
+	return result;
+}
+
+// Per-source totals of a bit-parallel multi-source BFS.
+struct MultiSourceBfsResult
+{
+	int mNumSources = 0;
+	std::array<double, 64> mDistanceSums = {};
+	std::array<std::int64_t, 64> mNumReached = {};
+	std::array<int, 64> mEccentricities = {};
+};
+
+// Multi-source BFS (Then et al.) for up to 64 sources: bit s of a node's word marks that source s
+// has reached it, so one pass over the graph advances all 64 searches. Levels are pulled per node,
+// which keeps the parallel sweep free of write conflicts.
+inline MultiSourceBfsResult multiSourceBfs(const CsrGraph &graph, const int *sources, int numSources)
+{
+	MultiSourceBfsResult result;
+	result.mNumSources = std::min(numSources, 64);
+	auto numNodes = graph.numNodes();
+	auto allSources = result.mNumSources == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << result.mNumSources) - 1;
+
+	std::vector<std::uint64_t> seen(numNodes, 0);
+	std::vector<std::uint64_t> visit(numNodes, 0);
+	std::vector<std::uint64_t> next(numNodes, 0);
+	for (auto s = 0; s < result.mNumSources; ++s)
+	{
+		seen[sources[s]] |= std::uint64_t(1) << s;
+		visit[sources[s]] |= std::uint64_t(1) << s;
+	}
+
+	auto threads = numThreads();
+	std::vector<std::array<std::int64_t, 64>> reached(threads);
+	for (auto level = 1;; ++level)
+	{
+		std::vector<char> active(threads, 0);
+		parallelRanges(numNodes, [&](int thread, std::size_t first, std::size_t last) {
+			reached[thread].fill(0);
+			for (auto v = first; v < last; ++v)
+			{
+				std::uint64_t bits = 0;
+				if (seen[v] != allSources)
+				{
+					for (auto u = graph.begin(v); u != graph.end(v); ++u)
+					{
+						bits |= visit[*u];
+					}
+					bits &= ~seen[v];
+				}
+				next[v] = bits;
+				for (; bits; bits &= bits - 1)
+				{
+					++reached[thread][__builtin_ctzll(bits)];
+				}
+			}
+		}, threads);
+
+		parallelRanges(numNodes, [&](int thread, std::size_t first, std::size_t last) {
+			for (auto v = first; v < last; ++v)
+			{
+				seen[v] |= next[v];
+				active[thread] |= next[v] != 0;
+			}
+		}, threads);
+		visit.swap(next);
+
+		if (std::none_of(active.begin(), active.end(), [](char a) { return a; }))
+		{
+			break;
+		}
+		for (auto s = 0; s < result.mNumSources; ++s)
+		{
+			std::int64_t count = 0;
+			for (const auto &counts : reached)
+			{
+				count += counts[s];
+			}
+			if (count > 0)
+			{
+				result.mDistanceSums[s] += static_cast<double>(count) * level;
+				result.mNumReached[s] += count;
+				result.mEccentricities[s] = level;
+			}
+		}
+	}
+	return result;
+}
+
+// Lower bound on the diameter by repeated double sweeps: BFS from a node, then again from the farthest
+// node found. Exact on trees and usually tight on sparse random graphs.
+inline int estimateDiameter(const CsrGraph &graph, int start, int numSweeps = 4)
+{
+	auto diameter = 0;
+	auto node = start;
+	for (auto sweep = 0; sweep < numSweeps && graph.numNodes() > 0; ++sweep)
+	{
+		auto distances = breadthFirstSearch(graph, node);
+		auto farthest = std::max_element(distances.begin(), distances.end());
+		if (*farthest <= diameter)
+		{
+			break;
+		}
+		diameter = *farthest;
+		node = static_cast<int>(farthest - distances.begin());
+	}
+	return diameter;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "edge_sink.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Undirected adjacency in compressed sparse row form. Each edge is stored in both directions,
+// neighbour lists are sorted, and self-loops and parallel edges are dropped.
+struct CsrGraph
+{
+	CsrGraph() = default;
+
+	CsrGraph(int numNodes, const std::vector<Edge> &edges)
+	{
+		build(numNodes, edges.size(), [&](std::size_t i) { return std::make_pair(edges[i].mHead, edges[i].mTail); });
+	}
+
+	CsrGraph(int numNodes, const std::vector<std::pair<int, int>> &pairs)
+	{
+		build(numNodes, pairs.size(), [&](std::size_t i) { return pairs[i]; });
+	}
+
+	int numNodes() const { return static_cast<int>(mOffsets.size()) - 1; }
+	std::size_t numArcs() const { return mNeighbors.size(); }
+	int degree(int node) const { return static_cast<int>(mOffsets[node + 1] - mOffsets[node]); }
+	const int *begin(int node) const { return mNeighbors.data() + mOffsets[node]; }
+	const int *end(int node) const { return mNeighbors.data() + mOffsets[node + 1]; }
+
+	std::vector<std::size_t> mOffsets;
+	std::vector<int> mNeighbors;
+
+private:
+	template <typename Endpoints>
+	void build(int numNodes, std::size_t numEdges, Endpoints endpoints)
+	{
+		mOffsets.assign(numNodes + 1, 0);
+		for (std::size_t i = 0; i < numEdges; ++i)
+		{
+			auto edge = endpoints(i);
+			if (edge.first != edge.second)
+			{
+				++mOffsets[edge.first + 1];
+				++mOffsets[edge.second + 1];
+			}
+		}
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			mOffsets[i + 1] += mOffsets[i];
+		}
+
+		mNeighbors.resize(mOffsets[numNodes]);
+		auto cursors = std::vector<std::size_t>(mOffsets.begin(), mOffsets.end() - 1);
+		for (std::size_t i = 0; i < numEdges; ++i)
+		{
+			auto edge = endpoints(i);
+			if (edge.first != edge.second)
+			{
+				mNeighbors[cursors[edge.first]++] = edge.second;
+				mNeighbors[cursors[edge.second]++] = edge.first;
+			}
+		}
+
+		std::size_t size = 0;
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			auto first = mNeighbors.begin() + mOffsets[i];
+			auto last = mNeighbors.begin() + mOffsets[i + 1];
+			std::sort(first, last);
+			last = std::unique(first, last);
+			mOffsets[i] = size;
+			size = std::copy(first, last, mNeighbors.begin() + size) - mNeighbors.begin();
+		}
+		mOffsets[numNodes] = size;
+		mNeighbors.resize(size);
+		mNeighbors.shrink_to_fit();
+	}
+};
+
+// Keeps only edge endpoints (8 bytes per edge) and turns them into a CsrGraph once generation is done.
+class CsrEdgeSink : public EdgeSink
+{
+public:
+	void consume(const Edge *edges, std::size_t count) override
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			mPairs.emplace_back(edges[i].mHead, edges[i].mTail);
+		}
+	}
+
+	CsrGraph build(int numNodes)
+	{
+		auto graph = CsrGraph(numNodes, mPairs);
+		mPairs.clear();
+		mPairs.shrink_to_fit();
+		return graph;
+	}
+
+private:
+	std::vector<std::pair<int, int>> mPairs;
+};
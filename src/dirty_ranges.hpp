@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Index ranges [first, last) changed since the last clear(), for uploading only what changed. Marks
+// made in increasing order, as from one pass over an array, extend the last range in O(1); others are
+// sorted and merged when the ranges are read. Ranges separated by fewer than mergeGap clean indices are
+// joined, since one slightly larger upload is cheaper than two calls.
+class DirtyRanges
+{
+public:
+	struct Range
+	{
+		std::size_t mFirst;
+		std::size_t mLast;
+	};
+
+	explicit DirtyRanges(std::size_t mergeGap = 32) : mMergeGap(mergeGap) {}
+
+	void mark(std::size_t index) { mark(index, index + 1); }
+
+	void mark(std::size_t first, std::size_t last)
+	{
+		if (first >= last)
+		{
+			return;
+		}
+		if (!mRanges.empty() && first >= mRanges.back().mFirst)
+		{
+			if (first <= mRanges.back().mLast + mMergeGap)
+			{
+				mRanges.back().mLast = std::max(mRanges.back().mLast, last);
+				return;
+			}
+		}
+		else if (!mRanges.empty())
+		{
+			mSorted = false;
+		}
+		mRanges.push_back(Range{first, last});
+	}
+
+	bool empty() const { return mRanges.empty(); }
+
+	const std::vector<Range> &ranges()
+	{
+		if (!mSorted)
+		{
+			std::sort(mRanges.begin(), mRanges.end(), [](const Range &a, const Range &b) { return a.mFirst < b.mFirst; });
+			std::size_t merged = 0;
+			for (std::size_t i = 1; i < mRanges.size(); ++i)
+			{
+				if (mRanges[i].mFirst <= mRanges[merged].mLast + mMergeGap)
+				{
+					mRanges[merged].mLast = std::max(mRanges[merged].mLast, mRanges[i].mLast);
+				}
+				else
+				{
+					mRanges[++merged] = mRanges[i];
+				}
+			}
+			mRanges.resize(merged + 1);
+			mSorted = true;
+		}
+		return mRanges;
+	}
+
+	void clear()
+	{
+		mRanges.clear();
+		mSorted = true;
+	}
+
+private:
+	std::size_t mMergeGap;
+	std::vector<Range> mRanges;
+	bool mSorted = true;
+};
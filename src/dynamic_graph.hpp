@@ -0,0 +1,197 @@
+#pragma once
+
+#include "graph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Edge handle that stays valid until the edge is removed, unlike its position in the edge vector.
+using EdgeId = std::uint32_t;
+constexpr EdgeId kInvalidEdge = ~EdgeId(0);
+
+// Mutable index over an edge vector owned by the caller (the app's mEdges), so physics and drawing
+// keep iterating a dense array. Removal is swap-and-pop: the last edge moves into the hole and its
+// id is re-pointed. Every edge has a slot holding its position and its place in both endpoint
+// adjacency lists, and adjacency entries are themselves swap-and-popped, so insert and remove are
+// O(1) amortised. A hash map from endpoint pair to id answers find() in O(1); multi-edges share one
+// entry with a count. Nodes can only be added, so node indices are stable handles as they are.
+class DynamicGraph
+{
+public:
+	struct Incidence
+	{
+		int mNeighbor;
+		EdgeId mEdge;
+	};
+
+	// Indexes edges as they are; assign again whenever the vector is replaced wholesale.
+	void assign(std::vector<Edge> &edges, int numNodes)
+	{
+		mEdges = &edges;
+		mIds.clear();
+		mSlots.clear();
+		mFreeSlots.clear();
+		mPairs.clear();
+		mPairs.reserve(edges.size());
+		mAdjacency.assign(numNodes, std::vector<Incidence>());
+		auto numEdges = edges.size();
+		for (std::size_t e = 0; e < numEdges; ++e)
+		{
+			index(e);
+		}
+	}
+
+	int numNodes() const { return static_cast<int>(mAdjacency.size()); }
+	std::size_t numEdges() const { return mIds.size(); }
+	int degree(int node) const { return static_cast<int>(mAdjacency[node].size()); }
+
+	// Neighbours of a node with the ids of the connecting edges; a self-loop appears twice.
+	const std::vector<Incidence> &neighbors(int node) const { return mAdjacency[node]; }
+
+	std::size_t position(EdgeId id) const { return mSlots[id].mPosition; }
+	EdgeId id(std::size_t position) const { return mIds[position]; }
+	const Edge &edge(EdgeId id) const { return (*mEdges)[mSlots[id].mPosition]; }
+	Edge &edge(EdgeId id) { return (*mEdges)[mSlots[id].mPosition]; }
+
+	// Some edge between u and v, or kInvalidEdge.
+	EdgeId find(int u, int v) const
+	{
+		auto pair = mPairs.find(pairKey(u, v));
+		return pair == mPairs.end() ? kInvalidEdge : pair->second.mEdge;
+	}
+
+	bool contains(int u, int v) const { return mPairs.count(pairKey(u, v)) != 0; }
+
+	int addNode()
+	{
+		mAdjacency.emplace_back();
+		return numNodes() - 1;
+	}
+
+	// Appends the edge, parallel edges and self-loops included; callers that keep the graph simple
+	// test contains() first.
+	EdgeId addEdge(const Edge &edge)
+	{
+		mEdges->push_back(edge);
+		return index(mEdges->size() - 1);
+	}
+
+	void removeEdge(EdgeId id)
+	{
+		auto &edges = *mEdges;
+		auto slot = mSlots[id];
+		auto head = edges[slot.mPosition].mHead;
+		auto tail = edges[slot.mPosition].mTail;
+
+		auto pair = mPairs.find(pairKey(head, tail));
+		if (--pair->second.mCount == 0)
+		{
+			mPairs.erase(pair);
+		}
+		else if (pair->second.mEdge == id)
+		{
+			// Only multi-edges get here: point the entry at a surviving copy.
+			for (const auto &incidence : mAdjacency[head])
+			{
+				if (incidence.mNeighbor == tail && incidence.mEdge != id)
+				{
+					pair->second.mEdge = incidence.mEdge;
+					break;
+				}
+			}
+		}
+
+		// The head entry is read only after the first unlink, which may move it when the edge is a self-loop.
+		unlink(tail, mSlots[id].mTailEntry);
+		unlink(head, mSlots[id].mHeadEntry);
+
+		auto last = edges.size() - 1;
+		if (slot.mPosition != last)
+		{
+			edges[slot.mPosition] = edges[last];
+			mIds[slot.mPosition] = mIds[last];
+			mSlots[mIds[last]].mPosition = slot.mPosition;
+		}
+		edges.pop_back();
+		mIds.pop_back();
+		mFreeSlots.push_back(id);
+	}
+
+private:
+	struct Slot
+	{
+		std::uint32_t mPosition;
+		std::uint32_t mHeadEntry;
+		std::uint32_t mTailEntry;
+	};
+
+	struct Pair
+	{
+		EdgeId mEdge;
+		int mCount;
+	};
+
+	// Unlike edgeKey, self-loops keep their node, so loops on different nodes stay distinct.
+	static std::uint64_t pairKey(int u, int v)
+	{
+		return static_cast<std::uint64_t>(static_cast<std::uint32_t>(std::min(u, v))) << 32 | static_cast<std::uint32_t>(std::max(u, v));
+	}
+
+	EdgeId index(std::size_t position)
+	{
+		const auto &edge = (*mEdges)[position];
+		EdgeId id;
+		if (mFreeSlots.empty())
+		{
+			id = static_cast<EdgeId>(mSlots.size());
+			mSlots.emplace_back();
+		}
+		else
+		{
+			id = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+		auto &slot = mSlots[id];
+		slot.mPosition = static_cast<std::uint32_t>(position);
+		slot.mHeadEntry = static_cast<std::uint32_t>(mAdjacency[edge.mHead].size());
+		mAdjacency[edge.mHead].push_back(Incidence{edge.mTail, id});
+		slot.mTailEntry = static_cast<std::uint32_t>(mAdjacency[edge.mTail].size());
+		mAdjacency[edge.mTail].push_back(Incidence{edge.mHead, id});
+		mIds.push_back(id);
+
+		auto pair = mPairs.emplace(pairKey(edge.mHead, edge.mTail), Pair{id, 0}).first;
+		++pair->second.mCount;
+		return id;
+	}
+
+	// Swap-and-pop of one adjacency entry; the entry moved into the hole has its slot re-pointed.
+	void unlink(int node, std::uint32_t entry)
+	{
+		auto &adjacency = mAdjacency[node];
+		auto moved = adjacency.back();
+		adjacency[entry] = moved;
+		adjacency.pop_back();
+		if (entry == adjacency.size())
+		{
+			return;
+		}
+		// A moved entry of a self-loop is its tail entry only if the head entry is still in place.
+		auto &slot = mSlots[moved.mEdge];
+		if ((*mEdges)[slot.mPosition].mTail == node && slot.mTailEntry == adjacency.size())
+		{
+			slot.mTailEntry = entry;
+		}
+		else
+		{
+			slot.mHeadEntry = entry;
+		}
+	}
+
+	std::vector<Edge> *mEdges = nullptr;
+	std::vector<EdgeId> mIds;
+	std::vector<Slot> mSlots;
+	std::vector<EdgeId> mFreeSlots;
+	std::unordered_map<std::uint64_t, Pair> mPairs;
+	std::vector<std::vector<Incidence>> mAdjacency;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Lock-free set of undirected edges: open addressing with linear probing over atomic 64-bit keys
+// (smaller endpoint in the high word, +1 so that zero marks an empty slot). Inserts claim a slot with
+// CAS, so concurrent inserts of the same edge agree on exactly one winner. Erased edges leave a
+// tombstone that is never reused, which keeps probe chains valid without locks; the capacity is
+// fixed up front at twice the expected number of inserts.
+class ConcurrentEdgeSet
+{
+public:
+	explicit ConcurrentEdgeSet(std::size_t maxEdges)
+	{
+		mCapacity = 16;
+		while (mCapacity < 2 * maxEdges)
+		{
+			mCapacity *= 2;
+		}
+		mSlots.reset(new std::atomic<std::uint64_t>[mCapacity]);
+		for (std::size_t i = 0; i < mCapacity; ++i)
+		{
+			mSlots[i].store(kEmpty, std::memory_order_relaxed);
+		}
+	}
+
+	// Returns false when the edge is already present.
+	bool insert(int u, int v)
+	{
+		auto key = encode(u, v);
+		for (auto slot = hash(key);; slot = (slot + 1) & (mCapacity - 1))
+		{
+			auto current = mSlots[slot].load(std::memory_order_acquire);
+			if (current == kEmpty)
+			{
+				if (mSlots[slot].compare_exchange_strong(current, key, std::memory_order_acq_rel))
+				{
+					return true;
+				}
+			}
+			if (current == key)
+			{
+				return false;
+			}
+		}
+	}
+
+	bool contains(int u, int v) const
+	{
+		auto key = encode(u, v);
+		for (auto slot = hash(key);; slot = (slot + 1) & (mCapacity - 1))
+		{
+			auto current = mSlots[slot].load(std::memory_order_acquire);
+			if (current == key)
+			{
+				return true;
+			}
+			if (current == kEmpty)
+			{
+				return false;
+			}
+		}
+	}
+
+	bool erase(int u, int v)
+	{
+		auto key = encode(u, v);
+		for (auto slot = hash(key);; slot = (slot + 1) & (mCapacity - 1))
+		{
+			auto current = mSlots[slot].load(std::memory_order_acquire);
+			if (current == key)
+			{
+				return mSlots[slot].compare_exchange_strong(current, kTombstone, std::memory_order_acq_rel);
+			}
+			if (current == kEmpty)
+			{
+				return false;
+			}
+		}
+	}
+
+private:
+	static constexpr std::uint64_t kEmpty = 0;
+	static constexpr std::uint64_t kTombstone = ~std::uint64_t(0);
+
+	static std::uint64_t encode(int u, int v)
+	{
+		if (u > v)
+		{
+			std::swap(u, v);
+		}
+		return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(u)) << 32 | static_cast<std::uint32_t>(v)) + 1;
+	}
+
+	// splitmix64 finaliser, so neighbouring lattice edges land far apart.
+	std::size_t hash(std::uint64_t key) const
+	{
+		key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+		key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+		return (key ^ (key >> 31)) & (mCapacity - 1);
+	}
+
+	std::size_t mCapacity;
+	std::unique_ptr<std::atomic<std::uint64_t>[]> mSlots;
+};
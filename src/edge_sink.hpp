@@ -0,0 +1,132 @@
+#pragma once
+
+#include "graph.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Receives generated edges in chunks so that a generator never has to hold the whole edge set.
+class EdgeSink
+{
+public:
+	virtual ~EdgeSink() = default;
+	virtual void consume(const Edge *, std::size_t) = 0;
+};
+
+class VectorEdgeSink : public EdgeSink
+{
+public:
+	explicit VectorEdgeSink(std::vector<Edge> &edges) : mEdges(edges) {}
+
+	void consume(const Edge *edges, std::size_t count) override
+	{
+		mEdges.insert(mEdges.end(), edges, edges + count);
+	}
+
+private:
+	std::vector<Edge> &mEdges;
+};
+
+class CallbackEdgeSink : public EdgeSink
+{
+public:
+	explicit CallbackEdgeSink(std::function<void(const Edge *, std::size_t)> callback) : mCallback(std::move(callback)) {}
+
+	void consume(const Edge *edges, std::size_t count) override
+	{
+		mCallback(edges, count);
+	}
+
+private:
+	std::function<void(const Edge *, std::size_t)> mCallback;
+};
+
+// Writes raw little-endian Edge records (head, tail, length, weight) to a file.
+class FileEdgeSink : public EdgeSink
+{
+public:
+	explicit FileEdgeSink(const std::string &path, std::size_t bufferSize = 1 << 24) : mBuffer(bufferSize)
+	{
+		mFile = std::fopen(path.c_str(), "wb");
+		if (!mFile)
+		{
+			throw std::runtime_error("cannot open " + path);
+		}
+		std::setvbuf(mFile, mBuffer.data(), _IOFBF, mBuffer.size());
+	}
+
+	// Errors cannot be reported from here; call close() to learn whether the final flush succeeded.
+	~FileEdgeSink() override
+	{
+		if (mFile)
+		{
+			std::fclose(mFile);
+		}
+	}
+
+	FileEdgeSink(const FileEdgeSink &) = delete;
+	FileEdgeSink &operator=(const FileEdgeSink &) = delete;
+
+	void consume(const Edge *edges, std::size_t count) override
+	{
+		if (!mFile || std::fwrite(edges, sizeof(Edge), count, mFile) != count)
+		{
+			throw std::runtime_error("failed to write edges");
+		}
+		mNumEdges += count;
+	}
+
+	// Flushes the buffer and closes the file; throws when either fails, e.g. on a full disk.
+	void close()
+	{
+		auto file = mFile;
+		mFile = nullptr;
+		if (file && std::fclose(file) != 0)
+		{
+			throw std::runtime_error("failed to close edge file");
+		}
+	}
+
+	std::size_t numEdges() const { return mNumEdges; }
+
+private:
+	std::FILE *mFile;
+	std::vector<char> mBuffer;
+	std::size_t mNumEdges = 0;
+};
+
+// Buffers single edges into fixed-size chunks for a sink; memory stays bounded by the chunk size.
+class EdgeStream
+{
+public:
+	EdgeStream(EdgeSink &sink, std::size_t chunkSize) : mSink(sink), mChunkSize(std::max<std::size_t>(chunkSize, 1))
+	{
+		mChunk.reserve(mChunkSize);
+	}
+
+	void emit(const Edge &edge)
+	{
+		mChunk.push_back(edge);
+		if (mChunk.size() == mChunkSize)
+		{
+			flush();
+		}
+	}
+
+	void flush()
+	{
+		if (!mChunk.empty())
+		{
+			mSink.consume(mChunk.data(), mChunk.size());
+			mChunk.clear();
+		}
+	}
+
+private:
+	EdgeSink &mSink;
+	std::size_t mChunkSize;
+	std::vector<Edge> mChunk;
+};
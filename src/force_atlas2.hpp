@@ -0,0 +1,151 @@
+#pragma once
+
+#include "barnes_hut.hpp"
+#include "dynamic_graph.hpp"
+#include "graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct ForceAtlas2Params
+{
+	float mScaling = 2.0f;
+	float mGravity = 1.0f;
+	bool mLinLog = false;
+	float mEdgeWeightInfluence = 0.0f;
+	float mJitterTolerance = 1.0f;
+	float mTheta = 1.2f;
+};
+
+// ForceAtlas2 (Jacomy et al. 2014): degree-weighted repulsion k_r (deg_i + 1)(deg_j + 1) / d through
+// Barnes-Hut, linear or LinLog attraction along edges, gravity towards the origin, and adaptive
+// speeds. Each node's speed shrinks with its own swinging (how much its force changes direction),
+// while a global speed follows the ratio of overall traction to swinging. Attraction and masses are
+// read from the DynamicGraph on every step, so a graph that grows or rewires in place costs nothing
+// extra. Self-loops are ignored; parallel edges each attract and each add to the mass.
+class ForceAtlas2
+{
+public:
+	void reset(int numNodes)
+	{
+		mPositions.assign(numNodes, ofVec3f());
+		mMasses.assign(numNodes, 1.0f);
+		mForces.assign(numNodes, ofVec3f());
+		mPreviousForces.assign(numNodes, ofVec3f());
+		mSpeed = 1.0f;
+		mSpeedEfficiency = 1.0f;
+	}
+
+	// For a graph that grows in place: the forces and speeds of existing nodes carry on, so the layout
+	// does not restart. New nodes start at rest.
+	void resize(int numNodes)
+	{
+		mPositions.resize(numNodes);
+		mMasses.resize(numNodes, 1.0f);
+		mForces.resize(numNodes);
+		mPreviousForces.resize(numNodes);
+	}
+
+	std::size_t numNodes() const { return mPositions.size(); }
+
+	void step(std::vector<Node> &nodes, const DynamicGraph &graph, const ForceAtlas2Params &params)
+	{
+		auto numNodes = static_cast<int>(mPositions.size());
+		parallelFor(numNodes, [&](std::size_t u) {
+			mPositions[u] = nodes[u].mPosition;
+			auto mass = 1.0f;
+			for (const auto &incidence : graph.neighbors(static_cast<int>(u)))
+			{
+				mass += incidence.mNeighbor != static_cast<int>(u);
+			}
+			mMasses[u] = mass;
+		});
+		mTree.build(mPositions, mMasses);
+
+		mPreviousForces.swap(mForces);
+		parallelFor(numNodes, [&](std::size_t u) {
+			auto mass = mMasses[u];
+			auto force = mTree.repulsion(mPositions[u], mass, static_cast<int>(u), params.mScaling, params.mTheta);
+
+			for (const auto &incidence : graph.neighbors(static_cast<int>(u)))
+			{
+				if (incidence.mNeighbor == static_cast<int>(u))
+				{
+					continue;
+				}
+				auto direction = mPositions[incidence.mNeighbor] - mPositions[u];
+				auto distance = direction.length();
+				auto weight = params.mEdgeWeightInfluence == 0 ? 1.0f : std::pow(graph.edge(incidence.mEdge).mWeight, params.mEdgeWeightInfluence);
+				if (params.mLinLog)
+				{
+					force += distance > 0 ? direction * (weight * std::log1p(distance) / distance) : ofVec3f();
+				}
+				else
+				{
+					force += direction * weight;
+				}
+			}
+
+			auto distance = mPositions[u].length();
+			if (distance > 0)
+			{
+				force -= mPositions[u] * (params.mGravity * mass / distance);
+			}
+			mForces[u] = force;
+		});
+
+		// Global speed from total swinging and traction, following the reference implementation.
+		double swinging = 0;
+		double traction = 0;
+		for (auto u = 0; u < numNodes; ++u)
+		{
+			auto mass = mMasses[u];
+			swinging += mass * (mForces[u] - mPreviousForces[u]).length();
+			traction += mass * (mForces[u] + mPreviousForces[u]).length() / 2;
+		}
+
+		auto estimatedJitter = 0.05 * std::sqrt(static_cast<double>(numNodes));
+		auto jitter = params.mJitterTolerance * std::max(std::sqrt(estimatedJitter), std::min(10.0, estimatedJitter * traction / (static_cast<double>(numNodes) * numNodes)));
+		if (traction > 0 && swinging / traction > 2.0)
+		{
+			mSpeedEfficiency = mSpeedEfficiency > 0.05f ? mSpeedEfficiency * 0.5f : mSpeedEfficiency;
+			jitter = std::max(jitter, static_cast<double>(params.mJitterTolerance));
+		}
+		if (swinging > 0)
+		{
+			auto targetSpeed = static_cast<float>(jitter * mSpeedEfficiency * traction / swinging);
+			if (swinging > jitter * traction)
+			{
+				mSpeedEfficiency = mSpeedEfficiency > 0.05f ? mSpeedEfficiency * 0.7f : mSpeedEfficiency;
+			}
+			else if (mSpeed < 1000)
+			{
+				mSpeedEfficiency *= 1.3f;
+			}
+			mSpeed += std::min(targetSpeed - mSpeed, 0.5f * mSpeed);
+		}
+
+		// Per-node speed: nodes that oscillate slow down, steady ones keep the global speed.
+		parallelFor(numNodes, [&](std::size_t u) {
+			auto swing = mMasses[u] * (mForces[u] - mPreviousForces[u]).length();
+			auto speed = mSpeed / (1.0f + std::sqrt(mSpeed * swing));
+			auto force = mForces[u].length();
+			if (force > 0)
+			{
+				nodes[u].mPosition += mForces[u] * std::min(speed, 10.0f / force);
+			}
+			nodes[u].mVelocity = ofVec3f();
+			nodes[u].mAcceleration = ofVec3f();
+		});
+	}
+
+private:
+	BarnesHutTree mTree;
+	std::vector<ofVec3f> mPositions;
+	std::vector<float> mMasses;
+	std::vector<ofVec3f> mForces;
+	std::vector<ofVec3f> mPreviousForces;
+	float mSpeed = 1.0f;
+	float mSpeedEfficiency = 1.0f;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ofVec3f.h"
+
+struct Node
+{
+	ofVec3f mPosition;
+	ofVec3f mVelocity;
+	ofVec3f mAcceleration;
+};
+
+struct Edge
+{
+	int mHead;
+	int mTail;
+	float mLength;
+	float mWeight;
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "graph.hpp"
+#include "parallel.hpp"
+#include <charconv>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Appends text into a caller-owned buffer; numbers go through std::to_chars.
+class TextBuffer
+{
+public:
+	explicit TextBuffer(std::vector<char> &buffer) : mBuffer(buffer) {}
+
+	TextBuffer &operator<<(std::string_view text)
+	{
+		mBuffer.insert(mBuffer.end(), text.begin(), text.end());
+		return *this;
+	}
+
+	TextBuffer &operator<<(char character)
+	{
+		mBuffer.push_back(character);
+		return *this;
+	}
+
+	template <typename Number>
+	std::enable_if_t<std::is_arithmetic<Number>::value, TextBuffer &> operator<<(Number number)
+	{
+		char digits[32];
+		auto result = std::to_chars(digits, digits + sizeof(digits), number);
+		mBuffer.insert(mBuffer.end(), digits, result.ptr);
+		return *this;
+	}
+
+private:
+	std::vector<char> &mBuffer;
+};
+
+// Writes records in blocks: every thread formats its slice of a block into its own buffer, then the
+// buffers are written in order, so output is deterministic and memory is bounded by the block size.
+class GraphWriter
+{
+public:
+	explicit GraphWriter(const std::string &path) : mPath(path), mBuffers(numThreads())
+	{
+		mFile = std::fopen(path.c_str(), "wb");
+		if (!mFile)
+		{
+			throw std::runtime_error("cannot open " + path);
+		}
+	}
+
+	~GraphWriter()
+	{
+		if (mFile)
+		{
+			std::fclose(mFile);
+		}
+	}
+
+	GraphWriter(const GraphWriter &) = delete;
+	GraphWriter &operator=(const GraphWriter &) = delete;
+
+	void write(std::string_view text)
+	{
+		if (std::fwrite(text.data(), 1, text.size(), mFile) != text.size())
+		{
+			throw std::runtime_error("failed to write " + mPath);
+		}
+	}
+
+	template <typename Format>
+	void writeRecords(std::size_t count, Format format)
+	{
+		static constexpr std::size_t kBlockSize = 1 << 20;
+		for (std::size_t block = 0; block < count; block += kBlockSize)
+		{
+			auto size = std::min(kBlockSize, count - block);
+			parallelRanges(size, [&](int thread, std::size_t first, std::size_t last) {
+				mBuffers[thread].clear();
+				TextBuffer text(mBuffers[thread]);
+				for (auto i = first; i < last; ++i)
+				{
+					format(text, block + i);
+				}
+			}, static_cast<int>(mBuffers.size()));
+			for (auto thread = 0; thread < static_cast<int>(mBuffers.size()) && thread < static_cast<int>(size); ++thread)
+			{
+				write(std::string_view(mBuffers[thread].data(), mBuffers[thread].size()));
+			}
+		}
+	}
+
+	void close()
+	{
+		auto file = mFile;
+		mFile = nullptr;
+		if (std::fclose(file) != 0)
+		{
+			throw std::runtime_error("failed to write " + mPath);
+		}
+	}
+
+private:
+	std::string mPath;
+	std::FILE *mFile;
+	std::vector<std::vector<char>> mBuffers;
+};
+
+// "head tail weight" per line; positions are not representable in an edge list.
+inline void exportEdgeList(const std::string &path, const std::vector<Node> &, const std::vector<Edge> &edges)
+{
+	GraphWriter writer(path);
+	writer.writeRecords(edges.size(), [&](TextBuffer &text, std::size_t i) {
+		text << edges[i].mHead << ' ' << edges[i].mTail << ' ' << edges[i].mWeight << '\n';
+	});
+	writer.close();
+}
+
+inline void exportGraphML(const std::string &path, const std::vector<Node> &nodes, const std::vector<Edge> &edges)
+{
+	GraphWriter writer(path);
+	writer.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+				 "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+				 "<key id=\"x\" for=\"node\" attr.name=\"x\" attr.type=\"float\"/>\n"
+				 "<key id=\"y\" for=\"node\" attr.name=\"y\" attr.type=\"float\"/>\n"
+				 "<key id=\"z\" for=\"node\" attr.name=\"z\" attr.type=\"float\"/>\n"
+				 "<key id=\"length\" for=\"edge\" attr.name=\"length\" attr.type=\"float\"/>\n"
+				 "<key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"float\"/>\n"
+				 "<graph edgedefault=\"undirected\">\n");
+	writer.writeRecords(nodes.size(), [&](TextBuffer &text, std::size_t i) {
+		const auto &position = nodes[i].mPosition;
+		text << "<node id=\"n" << i << "\"><data key=\"x\">" << position.x << "</data><data key=\"y\">" << position.y
+			 << "</data><data key=\"z\">" << position.z << "</data></node>\n";
+	});
+	writer.writeRecords(edges.size(), [&](TextBuffer &text, std::size_t i) {
+		text << "<edge source=\"n" << edges[i].mHead << "\" target=\"n" << edges[i].mTail << "\"><data key=\"length\">" << edges[i].mLength
+			 << "</data><data key=\"weight\">" << edges[i].mWeight << "</data></edge>\n";
+	});
+	writer.write("</graph>\n</graphml>\n");
+	writer.close();
+}
+
+inline void exportGEXF(const std::string &path, const std::vector<Node> &nodes, const std::vector<Edge> &edges)
+{
+	GraphWriter writer(path);
+	writer.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+				 "<gexf xmlns=\"http://www.gexf.net/1.2draft\" xmlns:viz=\"http://www.gexf.net/1.2draft/viz\" version=\"1.2\">\n"
+				 "<graph defaultedgetype=\"undirected\">\n<nodes>\n");
+	writer.writeRecords(nodes.size(), [&](TextBuffer &text, std::size_t i) {
+		const auto &position = nodes[i].mPosition;
+		text << "<node id=\"" << i << "\"><viz:position x=\"" << position.x << "\" y=\"" << position.y << "\" z=\"" << position.z << "\"/></node>\n";
+	});
+	writer.write("</nodes>\n<edges>\n");
+	writer.writeRecords(edges.size(), [&](TextBuffer &text, std::size_t i) {
+		text << "<edge id=\"" << i << "\" source=\"" << edges[i].mHead << "\" target=\"" << edges[i].mTail << "\" weight=\"" << edges[i].mWeight << "\"/>\n";
+	});
+	writer.write("</edges>\n</graph>\n</gexf>\n");
+	writer.close();
+}
+
+inline void exportDot(const std::string &path, const std::vector<Node> &nodes, const std::vector<Edge> &edges)
+{
+	GraphWriter writer(path);
+	writer.write("graph G {\ndim=3;\n");
+	writer.writeRecords(nodes.size(), [&](TextBuffer &text, std::size_t i) {
+		const auto &position = nodes[i].mPosition;
+		text << i << " [pos=\"" << position.x << ',' << position.y << ',' << position.z << "\"];\n";
+	});
+	writer.writeRecords(edges.size(), [&](TextBuffer &text, std::size_t i) {
+		text << edges[i].mHead << " -- " << edges[i].mTail << " [weight=" << edges[i].mWeight << ", len=" << edges[i].mLength << "];\n";
+	});
+	writer.write("}\n");
+	writer.close();
+}
+
+// Picks the format from the extension: .graphml, .gexf, .dot/.gv, anything else is an edge list.
+inline void exportGraph(const std::string &path, const std::vector<Node> &nodes, const std::vector<Edge> &edges)
+{
+	auto dot = path.rfind('.');
+	auto extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+	if (extension == "graphml")
+	{
+		exportGraphML(path, nodes, edges);
+	}
+	else if (extension == "gexf")
+	{
+		exportGEXF(path, nodes, edges);
+	}
+	else if (extension == "dot" || extension == "gv")
+	{
+		exportDot(path, nodes, edges);
+	}
+	else
+	{
+		exportEdgeList(path, nodes, edges);
+	}
+}
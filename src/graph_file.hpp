@@ -0,0 +1,220 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "graph files are little-endian and read without byte swapping");
+static_assert(sizeof(ofVec3f) == 3 * sizeof(float), "positions are mapped as packed ofVec3f");
+
+// Version 1 layout. Every section starts on a 64-byte boundary so it can be used in place from mmap:
+//   header (128 bytes)
+//   positions  float[3 * numNodes]
+//   offsets    uint64[numNodes + 1]   CSR row offsets
+//   neighbors  int32[numArcs]         CSR column indices, both directions, sorted per node
+//   heads      int32[numEdges]
+//   tails      int32[numEdges]
+//   lengths    float[numEdges]
+//   weights    float[numEdges]
+struct GraphFileHeader
+{
+	static constexpr char kMagic[8] = {'R', 'G', 'R', 'A', 'P', 'H', '\0', '\0'};
+	static constexpr std::uint32_t kVersion = 1;
+	static constexpr std::uint64_t kAlignment = 64;
+
+	char mMagic[8];
+	std::uint32_t mVersion;
+	std::uint32_t mHeaderSize;
+	std::uint64_t mNumNodes;
+	std::uint64_t mNumEdges;
+	std::uint64_t mNumArcs;
+	std::uint64_t mPositionsOffset;
+	std::uint64_t mOffsetsOffset;
+	std::uint64_t mNeighborsOffset;
+	std::uint64_t mHeadsOffset;
+	std::uint64_t mTailsOffset;
+	std::uint64_t mLengthsOffset;
+	std::uint64_t mWeightsOffset;
+	std::uint64_t mFileSize;
+	char mReserved[24];
+};
+
+static_assert(sizeof(GraphFileHeader) == 128, "header size is part of the format");
+
+inline void writeGraphFile(const std::string &path, const std::vector<Node> &nodes, const std::vector<Edge> &edges, const CsrGraph &csr)
+{
+	auto align = [](std::uint64_t offset) { return (offset + GraphFileHeader::kAlignment - 1) / GraphFileHeader::kAlignment * GraphFileHeader::kAlignment; };
+
+	GraphFileHeader header = {};
+	std::memcpy(header.mMagic, GraphFileHeader::kMagic, sizeof(header.mMagic));
+	header.mVersion = GraphFileHeader::kVersion;
+	header.mHeaderSize = sizeof(GraphFileHeader);
+	header.mNumNodes = nodes.size();
+	header.mNumEdges = edges.size();
+	header.mNumArcs = csr.numArcs();
+	header.mPositionsOffset = align(sizeof(GraphFileHeader));
+	header.mOffsetsOffset = align(header.mPositionsOffset + header.mNumNodes * 3 * sizeof(float));
+	header.mNeighborsOffset = align(header.mOffsetsOffset + (header.mNumNodes + 1) * sizeof(std::uint64_t));
+	header.mHeadsOffset = align(header.mNeighborsOffset + header.mNumArcs * sizeof(std::int32_t));
+	header.mTailsOffset = align(header.mHeadsOffset + header.mNumEdges * sizeof(std::int32_t));
+	header.mLengthsOffset = align(header.mTailsOffset + header.mNumEdges * sizeof(std::int32_t));
+	header.mWeightsOffset = align(header.mLengthsOffset + header.mNumEdges * sizeof(float));
+	header.mFileSize = header.mWeightsOffset + header.mNumEdges * sizeof(float);
+
+	auto file = std::fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		throw std::runtime_error("cannot open " + path);
+	}
+	std::vector<char> buffer(1 << 24);
+	std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+	std::uint64_t position = 0;
+	auto write = [&](std::uint64_t offset, const void *data, std::size_t size) {
+		static const char padding[GraphFileHeader::kAlignment] = {};
+		if (std::fwrite(padding, 1, offset - position, file) != offset - position || std::fwrite(data, 1, size, file) != size)
+		{
+			std::fclose(file);
+			throw std::runtime_error("failed to write " + path);
+		}
+		position = offset + size;
+	};
+	// Columns are gathered in slices so the writer needs no full copy of the edge list.
+	auto writeColumn = [&](std::uint64_t offset, std::size_t count, auto column) {
+		using Value = decltype(column(0));
+		std::vector<Value> slice;
+		for (std::size_t first = 0; first < count; first += 1 << 20)
+		{
+			auto last = std::min<std::size_t>(first + (1 << 20), count);
+			slice.clear();
+			for (auto i = first; i < last; ++i)
+			{
+				slice.push_back(column(i));
+			}
+			write(first == 0 ? offset : position, slice.data(), slice.size() * sizeof(Value));
+		}
+	};
+
+	write(0, &header, sizeof(header));
+	writeColumn(header.mPositionsOffset, nodes.size(), [&](std::size_t i) { return nodes[i].mPosition; });
+	std::vector<std::uint64_t> offsets(csr.mOffsets.begin(), csr.mOffsets.end());
+	offsets.resize(header.mNumNodes + 1, csr.numArcs());
+	write(header.mOffsetsOffset, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+	write(header.mNeighborsOffset, csr.mNeighbors.data(), csr.mNeighbors.size() * sizeof(std::int32_t));
+	writeColumn(header.mHeadsOffset, edges.size(), [&](std::size_t i) { return static_cast<std::int32_t>(edges[i].mHead); });
+	writeColumn(header.mTailsOffset, edges.size(), [&](std::size_t i) { return static_cast<std::int32_t>(edges[i].mTail); });
+	writeColumn(header.mLengthsOffset, edges.size(), [&](std::size_t i) { return edges[i].mLength; });
+	writeColumn(header.mWeightsOffset, edges.size(), [&](std::size_t i) { return edges[i].mWeight; });
+
+	if (std::fclose(file) != 0)
+	{
+		throw std::runtime_error("failed to write " + path);
+	}
+}
+
+// Zero-copy view of a graph file. The mapping is private and writable, so callers may integrate
+// positions in place without the changes ever reaching the file.
+class MappedGraphFile
+{
+public:
+	explicit MappedGraphFile(const std::string &path) : mFile(path), mPath(path)
+	{
+		mHeader = reinterpret_cast<const GraphFileHeader *>(mFile.data());
+		if (mFile.size() < sizeof(GraphFileHeader) ||
+			std::memcmp(mHeader->mMagic, GraphFileHeader::kMagic, sizeof(mHeader->mMagic)) != 0 ||
+			mHeader->mVersion != GraphFileHeader::kVersion || mHeader->mFileSize > mFile.size())
+		{
+			throw std::runtime_error(path + " is not a version " + std::to_string(GraphFileHeader::kVersion) + " graph file");
+		}
+		// Endpoints are int32, and every section must lie inside the file, so a truncated or corrupt
+		// header cannot send readers past the mapping.
+		const auto &header = *mHeader;
+		if (header.mNumNodes > INT32_MAX || header.mNumEdges > INT32_MAX || header.mNumArcs > UINT64_MAX / 2 ||
+			!validSection(header.mPositionsOffset, header.mNumNodes, 3 * sizeof(float)) ||
+			!validSection(header.mOffsetsOffset, header.mNumNodes + 1, sizeof(std::uint64_t)) ||
+			!validSection(header.mNeighborsOffset, header.mNumArcs, sizeof(std::int32_t)) ||
+			!validSection(header.mHeadsOffset, header.mNumEdges, sizeof(std::int32_t)) ||
+			!validSection(header.mTailsOffset, header.mNumEdges, sizeof(std::int32_t)) ||
+			!validSection(header.mLengthsOffset, header.mNumEdges, sizeof(float)) ||
+			!validSection(header.mWeightsOffset, header.mNumEdges, sizeof(float)))
+		{
+			throw std::runtime_error(path + " is truncated or corrupt");
+		}
+		mFile.advise(MADV_WILLNEED);
+	}
+
+	const GraphFileHeader &header() const { return *mHeader; }
+	std::size_t numNodes() const { return mHeader->mNumNodes; }
+	std::size_t numEdges() const { return mHeader->mNumEdges; }
+	std::size_t numArcs() const { return mHeader->mNumArcs; }
+
+	ofVec3f *positions() { return section<ofVec3f>(mHeader->mPositionsOffset); }
+	const std::uint64_t *offsets() const { return section<std::uint64_t>(mHeader->mOffsetsOffset); }
+	const std::int32_t *neighbors() const { return section<std::int32_t>(mHeader->mNeighborsOffset); }
+	const std::int32_t *heads() const { return section<std::int32_t>(mHeader->mHeadsOffset); }
+	const std::int32_t *tails() const { return section<std::int32_t>(mHeader->mTailsOffset); }
+	const float *lengths() const { return section<float>(mHeader->mLengthsOffset); }
+	const float *weights() const { return section<float>(mHeader->mWeightsOffset); }
+
+	// Copies the stored adjacency after checking it has the shape CsrGraph promises: offsets start at 0,
+	// never decrease and end at numArcs, and each row is strictly increasing with neighbours in range
+	// and no self-loops. Traversals index by these values, so they are checked before use.
+	CsrGraph csr() const
+	{
+		auto numNodes = static_cast<std::int32_t>(this->numNodes());
+		auto offsets = this->offsets();
+		auto neighbors = this->neighbors();
+		if (offsets[0] != 0 || offsets[numNodes] != numArcs())
+		{
+			throw std::runtime_error(mPath + ": CSR offsets do not span the neighbour section");
+		}
+		// Offsets first, so no row can reach past the neighbour section.
+		for (std::int32_t i = 0; i < numNodes; ++i)
+		{
+			if (offsets[i] > offsets[i + 1])
+			{
+				throw std::runtime_error(mPath + ": CSR offsets of node " + std::to_string(i) + " decrease");
+			}
+		}
+		CsrGraph graph;
+		graph.mOffsets.assign(offsets, offsets + numNodes + 1);
+		graph.mNeighbors.assign(neighbors, neighbors + numArcs());
+		for (std::int32_t i = 0; i < numNodes; ++i)
+		{
+			for (auto k = offsets[i]; k < offsets[i + 1]; ++k)
+			{
+				auto j = neighbors[k];
+				if (j < 0 || j >= numNodes || j == i || (k > offsets[i] && j <= neighbors[k - 1]))
+				{
+					throw std::runtime_error(mPath + ": CSR neighbours of node " + std::to_string(i) + " are out of range or unsorted");
+				}
+			}
+		}
+		return graph;
+	}
+
+private:
+	// Aligned, after the header and inside the file; count * size is compared by division so it cannot
+	// overflow.
+	bool validSection(std::uint64_t offset, std::uint64_t count, std::uint64_t size) const
+	{
+		return offset % GraphFileHeader::kAlignment == 0 && offset >= sizeof(GraphFileHeader) && offset <= mHeader->mFileSize &&
+			   count <= (mHeader->mFileSize - offset) / size;
+	}
+
+	template <typename T>
+	T *section(std::uint64_t offset) const
+	{
+		return reinterpret_cast<T *>(mFile.data() + offset);
+	}
+
+	MappedFile mFile;
+	std::string mPath;
+	const GraphFileHeader *mHeader;
+};
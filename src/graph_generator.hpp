@@ -0,0 +1,1031 @@
+#pragma once
+
+#include "edge_set.hpp"
+#include "edge_sink.hpp"
+#include "node_placement.hpp"
+#include "uniform_grid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+inline Node generateNode(std::mt19937 &engine, float radiusMean, float radiusStd)
+{
+	auto radius = std::normal_distribution<float>(radiusMean, radiusStd)(engine);
+	auto theta = std::uniform_real_distribution<float>(-M_PI, +M_PI)(engine);
+	auto phi = std::uniform_real_distribution<float>(-M_PI, +M_PI)(engine);
+
+	return Node{ofVec3f(radius * std::sin(theta) * std::cos(phi),
+						radius * std::sin(theta) * std::sin(phi),
+						radius * std::cos(theta))};
+}
+
+// Batch placement through placeNodes, a block at a time per thread, then scattered into the nodes.
+// Small graphs stay on the calling thread: starting workers costs more than placing them, and batch
+// jobs already run one per thread.
+inline void generateNodes(std::mt19937 &engine, std::vector<Node> &nodes, int numNodes, float radiusMean, float radiusStd, NodePlacement mode = NodePlacement::Angles)
+{
+	auto key = placement::key(engine);
+	nodes.assign(numNodes, Node());
+	auto numBlocks = (static_cast<std::size_t>(numNodes) + placement::kBlockSize - 1) / placement::kBlockSize;
+	parallelRanges(numBlocks, [&](int, std::size_t firstBlock, std::size_t lastBlock) {
+		float x[placement::kBlockSize];
+		float y[placement::kBlockSize];
+		float z[placement::kBlockSize];
+		for (auto block = firstBlock; block < lastBlock; ++block)
+		{
+			auto first = block * placement::kBlockSize;
+			auto count = std::min<std::size_t>(placement::kBlockSize, numNodes - first);
+			placeNodes(key, first, count, radiusMean, radiusStd, mode, x, y, z);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				nodes[first + i].mPosition = ofVec3f(x[i], y[i], z[i]);
+			}
+		}
+	}, numNodes < (1 << 16) ? 1 : numThreads());
+}
+
+// Parameters resolved once per graph, so generators never look anything up by name.
+struct GeneratorParams
+{
+	float mRadiusMean = 100.0f;
+	float mRadiusStd = 10.0f;
+	float mEdgeWeightMin = 0.0f;
+	float mEdgeWeightMax = 0.1f;
+	NodePlacement mPlacement = NodePlacement::Angles;
+};
+
+// xoshiro256** (Blackman & Vigna): a few cycles per 64-bit draw, against about ten nanoseconds per
+// 32 bits for mt19937. Satisfies UniformRandomBitGenerator, so std distributions accept it too.
+class Xoshiro256
+{
+public:
+	using result_type = std::uint64_t;
+
+	// The state is filled from a seeded engine, so runs stay reproducible from the app's mt19937.
+	explicit Xoshiro256(std::mt19937 &engine)
+	{
+		for (auto &word : mState)
+		{
+			word = static_cast<std::uint64_t>(engine()) << 32 | engine();
+		}
+		if ((mState[0] | mState[1] | mState[2] | mState[3]) == 0)
+		{
+			mState[0] = 1;
+		}
+	}
+
+	// Independent streams from one key, e.g. one per ring segment: splitmix64 expands key + stream.
+	Xoshiro256(std::uint64_t key, std::uint64_t stream)
+	{
+		auto x = key + stream * 0x9e3779b97f4a7c15ull;
+		for (auto &word : mState)
+		{
+			x += 0x9e3779b97f4a7c15ull;
+			auto z = x;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			word = z ^ (z >> 31);
+		}
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~result_type(0); }
+
+	result_type operator()()
+	{
+		auto result = rotate(mState[1] * 5, 7) * 9;
+		auto shifted = mState[1] << 17;
+		mState[2] ^= mState[0];
+		mState[3] ^= mState[1];
+		mState[1] ^= mState[2];
+		mState[0] ^= mState[3];
+		mState[2] ^= shifted;
+		mState[3] = rotate(mState[3], 45);
+		return result;
+	}
+
+	// Uniform double in [0, 1) with 53 random bits.
+	double uniform() { return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+
+	// Uniform integer in [0, bound), bound > 0, by Lemire's multiply-shift with rejection.
+	std::uint64_t index(std::uint64_t bound)
+	{
+		auto product = static_cast<unsigned __int128>((*this)()) * bound;
+		if (static_cast<std::uint64_t>(product) < bound)
+		{
+			auto threshold = -bound % bound;
+			while (static_cast<std::uint64_t>(product) < threshold)
+			{
+				product = static_cast<unsigned __int128>((*this)()) * bound;
+			}
+		}
+		return static_cast<std::uint64_t>(product >> 64);
+	}
+
+private:
+	static std::uint64_t rotate(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	std::uint64_t mState[4];
+};
+
+// Per-graph generation state: resolved parameters and a fast engine seeded once from the caller's
+// mt19937, with the distributions reduced to arithmetic on its output. Edge weights are drawn
+// kWeightBatch at a time into a buffer, and bounded integers use Lemire's multiply-shift rejection
+// instead of a uniform_int_distribution constructed per draw.
+class GeneratorContext
+{
+public:
+	static constexpr std::size_t kWeightBatch = 4096;
+
+	GeneratorContext(std::mt19937 &engine, const GeneratorParams &params)
+		: mEngine(engine), mParams(params), mFast(engine), mWeightScale((params.mEdgeWeightMax - params.mEdgeWeightMin) / 16777216.0f)
+	{
+	}
+
+	std::mt19937 &engine() { return mEngine; }
+	const GeneratorParams &params() const { return mParams; }
+
+	void placeNodes(std::vector<Node> &nodes, int numNodes)
+	{
+		generateNodes(mEngine, nodes, numNodes, mParams.mRadiusMean, mParams.mRadiusStd, mParams.mPlacement);
+	}
+
+	Xoshiro256 &fast() { return mFast; }
+	double uniform() { return mFast.uniform(); }
+	std::uint64_t index(std::uint64_t bound) { return mFast.index(bound); }
+
+	// Weight from 24 random bits, for generators that draw on their own per-thread engines.
+	float weight(std::uint64_t bits) const { return mParams.mEdgeWeightMin + static_cast<float>(bits >> 40) * mWeightScale; }
+
+	// Uniform in [mEdgeWeightMin, mEdgeWeightMax); each 64-bit draw yields two 24-bit weights.
+	float weight()
+	{
+		if (mNextWeight == mWeightBuffer.size())
+		{
+			mWeightBuffer.resize(kWeightBatch);
+			for (std::size_t i = 0; i < kWeightBatch; i += 2)
+			{
+				auto bits = mFast();
+				mWeightBuffer[i] = mParams.mEdgeWeightMin + static_cast<float>(bits >> 40) * mWeightScale;
+				mWeightBuffer[i + 1] = mParams.mEdgeWeightMin + static_cast<float>(bits >> 8 & 0xffffff) * mWeightScale;
+			}
+			mNextWeight = 0;
+		}
+		return mWeightBuffer[mNextWeight++];
+	}
+
+	Edge edge(const std::vector<Node> &nodes, int head, int tail)
+	{
+		return Edge{head, tail, nodes[head].mPosition.distance(nodes[tail].mPosition), weight()};
+	}
+
+private:
+	std::mt19937 &mEngine;
+	GeneratorParams mParams;
+	Xoshiro256 mFast;
+	float mWeightScale;
+	std::vector<float> mWeightBuffer;
+	std::size_t mNextWeight = 0;
+};
+
+// The stream* generators take already placed nodes and emit edges into an EdgeStream, so the edge
+// set is never materialised unless the sink chooses to keep it.
+
+// Batagelj-Brandes geometric skipping over the pairs (i, j), j < i: O(n + m) instead of O(n^2) trials.
+inline void streamErdosRenyi(GeneratorContext &context, const std::vector<Node> &nodes, float edgeProb, EdgeStream &stream)
+{
+	auto numNodes = static_cast<std::int64_t>(nodes.size());
+	auto logComplement = std::log1p(-std::min<double>(edgeProb, 1.0));
+
+	if (edgeProb <= 0)
+	{
+		stream.flush();
+		return;
+	}
+
+	std::int64_t i = 1;
+	std::int64_t j = -1;
+	while (i < numNodes)
+	{
+		auto skip = edgeProb >= 1 ? 0.0 : std::floor(std::log1p(-context.uniform()) / logComplement);
+		j += 1 + static_cast<std::int64_t>(std::min(skip, static_cast<double>(numNodes * numNodes)));
+		while (j >= i && i < numNodes)
+		{
+			j -= i;
+			++i;
+		}
+		if (i < numNodes)
+		{
+			stream.emit(context.edge(nodes, static_cast<int>(i), static_cast<int>(j)));
+		}
+	}
+	stream.flush();
+}
+
+// Preferential attachment against a Fenwick tree of degrees: O(log n) per draw and O(n) memory,
+// independent of the number of edges already emitted.
+inline void streamBarabasiAlbert(GeneratorContext &context, const std::vector<Node> &nodes, int numEdges, EdgeStream &stream)
+{
+	auto numNodes = static_cast<int>(nodes.size());
+	auto initialNodes = std::min(numEdges, numNodes);
+
+	std::vector<std::int64_t> tree(numNodes + 1, 0);
+	auto addDegree = [&](int node, std::int64_t delta) {
+		for (auto k = node + 1; k <= numNodes; k += k & -k)
+		{
+			tree[k] += delta;
+		}
+	};
+	auto findNode = [&](std::int64_t target) {
+		auto node = 0;
+		for (auto step = 1 << static_cast<int>(std::log2(std::max(numNodes, 1))); step > 0; step >>= 1)
+		{
+			if (node + step <= numNodes && tree[node + step] <= target)
+			{
+				node += step;
+				target -= tree[node];
+			}
+		}
+		return node;
+	};
+
+	for (auto i = 0; i < initialNodes; ++i)
+	{
+		for (auto j = 0; j < i; ++j)
+		{
+			stream.emit(context.edge(nodes, i, j));
+		}
+		addDegree(i, initialNodes - 1);
+	}
+
+	std::int64_t totalDegree = static_cast<std::int64_t>(initialNodes) * (initialNodes - 1);
+	std::vector<int> targets(numEdges);
+	for (auto i = initialNodes; i < numNodes; ++i)
+	{
+		for (auto &k : targets)
+		{
+			k = totalDegree > 0 ? findNode(context.index(totalDegree)) : static_cast<int>(context.index(i));
+			stream.emit(context.edge(nodes, i, k));
+		}
+		for (auto k : targets)
+		{
+			addDegree(k, 1);
+		}
+		addDegree(i, numEdges);
+		totalDegree += 2 * numEdges;
+	}
+	stream.flush();
+}
+
+// Spatial k-nearest-neighbour lattice with random rewiring; one row of distances is live at a time.
+// A node is never its own neighbour, even among coincident nodes, and never rewires to itself.
+inline void streamWattsStrogatz(GeneratorContext &context, const std::vector<Node> &nodes, int numNeighbors, float rewireProb, EdgeStream &stream)
+{
+	auto numNodes = static_cast<int>(nodes.size());
+	numNeighbors = std::max(std::min(numNeighbors, numNodes - 1), 0);
+
+	std::vector<std::pair<float, int>> norms(numNodes);
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		for (auto j = 0; j < numNodes; ++j)
+		{
+			norms[j] = std::make_pair(nodes[j].mPosition.distance(nodes[i].mPosition), j);
+		}
+		norms[i].first = std::numeric_limits<float>::infinity();
+		std::partial_sort(norms.begin(), norms.begin() + numNeighbors, norms.end());
+		for (auto j = 0; j < numNeighbors; ++j)
+		{
+			auto k = norms[j].second;
+			if (context.uniform() < rewireProb)
+			{
+				k = static_cast<int>(context.index(numNodes - 1));
+				k += k >= i;
+			}
+			stream.emit(context.edge(nodes, i, k));
+		}
+	}
+	stream.flush();
+}
+
+// Canonical Watts-Strogatz (1998): a ring lattice where node i links to i+1 .. i+k/2 (mod n), then
+// every lattice edge (i, i+j) is rewired with probability p to (i, w), redrawing w on self-loops and
+// on edges already present. All current edges live in a ConcurrentEdgeSet, so the rejection test is
+// O(1) and fixed-size segments of the ring are rewired in parallel, each from its own engine stream;
+// O(n k) time and memory. The edge set can only depend on thread timing when two threads race for
+// the same new edge. A node adjacent to nearly everyone keeps its lattice edge after kMaxAttempts
+// failed draws, standing in for the reference implementation's full-degree check.
+inline void streamWattsStrogatzRing(GeneratorContext &context, const std::vector<Node> &nodes, int numNeighbors, float rewireProb, EdgeStream &stream)
+{
+	constexpr int kSegmentSize = 1 << 14;
+	constexpr int kMaxAttempts = 64;
+
+	auto numNodes = static_cast<int>(nodes.size());
+	auto half = std::min(numNeighbors / 2, (numNodes - 1) / 2);
+	if (half <= 0)
+	{
+		stream.flush();
+		return;
+	}
+	auto numEdges = static_cast<std::size_t>(numNodes) * half;
+	auto numSegments = (static_cast<std::size_t>(numNodes) + kSegmentSize - 1) / kSegmentSize;
+	auto threads = numEdges < (1 << 16) ? 1 : numThreads();
+	auto key = context.fast()();
+
+	ConcurrentEdgeSet edgeSet(numEdges + static_cast<std::size_t>(1.1 * rewireProb * numEdges) + 1024);
+	parallelRanges(numNodes, [&](int, std::size_t first, std::size_t last) {
+		for (auto i = first; i < last; ++i)
+		{
+			for (auto j = 1; j <= half; ++j)
+			{
+				edgeSet.insert(static_cast<int>(i), static_cast<int>((i + j) % numNodes));
+			}
+		}
+	}, threads);
+
+	std::vector<Edge> edges(numEdges);
+	parallelRanges(numSegments, [&](int, std::size_t firstSegment, std::size_t lastSegment) {
+		for (auto segment = firstSegment; segment < lastSegment; ++segment)
+		{
+			Xoshiro256 engine(key, segment);
+			auto last = std::min<std::size_t>((segment + 1) * kSegmentSize, numNodes);
+			for (auto i = static_cast<int>(segment * kSegmentSize); i < static_cast<int>(last); ++i)
+			{
+				for (auto j = 1; j <= half; ++j)
+				{
+					auto v = (i + j) % numNodes;
+					if (engine.uniform() < rewireProb)
+					{
+						for (auto attempt = 0; attempt < kMaxAttempts; ++attempt)
+						{
+							auto w = static_cast<int>(engine.index(numNodes));
+							if (w != i && edgeSet.insert(i, w))
+							{
+								edgeSet.erase(i, v);
+								v = w;
+								break;
+							}
+						}
+					}
+					edges[static_cast<std::size_t>(i) * half + j - 1] = Edge{i, v, nodes[i].mPosition.distance(nodes[v].mPosition), context.weight(engine())};
+				}
+			}
+		}
+	}, threads);
+
+	for (const auto &edge : edges)
+	{
+		stream.emit(edge);
+	}
+	stream.flush();
+}
+
+// Runs generate(task, edges) for tasks 0 .. numTasks - 1 and emits their edges in task order. Tasks
+// go a round at a time, pulled by the threads from a shared counter so uneven tasks still balance,
+// and memory stays at one round's edges. Generators seed one engine stream per task, so the output
+// does not depend on the thread count.
+template <typename Generate>
+void emitTasks(std::size_t numTasks, int threads, Generate generate, EdgeStream &stream)
+{
+	constexpr std::size_t kTasksPerThread = 4;
+
+	std::vector<std::vector<Edge>> buffers(std::max<std::size_t>(1, std::min<std::size_t>(threads * kTasksPerThread, numTasks)));
+	for (std::size_t firstTask = 0; firstTask < numTasks; firstTask += buffers.size())
+	{
+		auto lastTask = std::min(firstTask + buffers.size(), numTasks);
+		std::atomic<std::size_t> nextTask(firstTask);
+		parallelRanges(threads, [&](int, std::size_t, std::size_t) {
+			for (auto task = nextTask++; task < lastTask; task = nextTask++)
+			{
+				buffers[task - firstTask].clear();
+				generate(task, buffers[task - firstTask]);
+			}
+		}, threads);
+		for (auto task = firstTask; task < lastTask; ++task)
+		{
+			for (const auto &edge : buffers[task - firstTask])
+			{
+				stream.emit(edge);
+			}
+		}
+	}
+	stream.flush();
+}
+
+// Fills in mLength for edges whose endpoints are scattered over the node array: a separate pass that
+// prefetches a few edges ahead hides most of the cache misses.
+inline void setEdgeLengths(const std::vector<Node> &nodes, std::vector<Edge> &edges)
+{
+	constexpr std::size_t kPrefetchDistance = 16;
+
+	for (std::size_t e = 0; e < edges.size(); ++e)
+	{
+		if (e + kPrefetchDistance < edges.size())
+		{
+			__builtin_prefetch(&nodes[edges[e + kPrefetchDistance].mHead]);
+			__builtin_prefetch(&nodes[edges[e + kPrefetchDistance].mTail]);
+		}
+		edges[e].mLength = nodes[edges[e].mHead].mPosition.distance(nodes[edges[e].mTail].mPosition);
+	}
+}
+
+// Undirected edge packed with the smaller endpoint high, so sorting groups repeats; self-loops map to
+// kLoopKey, which sorts last.
+constexpr std::uint64_t kLoopKey = ~std::uint64_t(0);
+
+inline std::uint64_t edgeKey(std::uint32_t u, std::uint32_t v)
+{
+	return u == v ? kLoopKey : static_cast<std::uint64_t>(std::min(u, v)) << 32 | std::max(u, v);
+}
+
+// Sorts edge keys in parallel and emits every distinct edge once, dropping self-loops.
+inline void emitDistinctEdges(GeneratorContext &context, const std::vector<Node> &nodes, std::vector<std::uint64_t> &keys, int threads, EdgeStream &stream)
+{
+	constexpr std::size_t kPrefetchDistance = 16;
+
+	parallelSort(keys.begin(), keys.end(), std::less<std::uint64_t>(), threads);
+	for (std::size_t e = 0; e < keys.size() && keys[e] != kLoopKey; ++e)
+	{
+		// Tails are scattered over the node array; heads ascend.
+		if (e + kPrefetchDistance < keys.size() && keys[e + kPrefetchDistance] != kLoopKey)
+		{
+			__builtin_prefetch(&nodes[keys[e + kPrefetchDistance] & 0xffffffff]);
+		}
+		if (e == 0 || keys[e] != keys[e - 1])
+		{
+			stream.emit(context.edge(nodes, static_cast<int>(keys[e] >> 32), static_cast<int>(keys[e] & 0xffffffff)));
+		}
+	}
+	stream.flush();
+}
+
+// Recursive-matrix quadrant probabilities; d = 1 - a - b - c. The defaults are Graph500's.
+struct RmatParams
+{
+	float mA = 0.57f;
+	float mB = 0.19f;
+	float mC = 0.19f;
+	int mEdgeFactor = 16;
+	// Relabel vertices by a random permutation, so vertex ids carry no degree information.
+	bool mPermute = true;
+	// Drop self-loops and parallel edges; without this the raw R-MAT multigraph is streamed.
+	bool mDedupe = true;
+};
+
+// R-MAT (Chakrabarti, Zhan & Faloutsos 2004), the stochastic Kronecker generator behind Graph500:
+// each of mEdgeFactor * n edges descends ceil(log2 n) levels of the adjacency matrix, picking a
+// quadrant with probabilities (a, b, c, d) at every level; edges landing outside [0, n) are redrawn.
+// Edges are drawn in fixed chunks, each from its own engine stream, so the graph does not depend on
+// the thread count. Without mDedupe chunks are streamed through emitTasks; with it the pairs are
+// packed into edge keys, parallel-sorted and emitted once.
+inline void streamRmat(GeneratorContext &context, const std::vector<Node> &nodes, const RmatParams &params, EdgeStream &stream)
+{
+	constexpr std::size_t kChunkSize = 1 << 16;
+
+	auto numNodes = static_cast<std::uint64_t>(nodes.size());
+	auto numEdges = numNodes * std::max(params.mEdgeFactor, 0);
+	if (numNodes < 2 || numEdges == 0)
+	{
+		stream.flush();
+		return;
+	}
+	auto scale = 0;
+	while ((std::uint64_t(1) << scale) < numNodes)
+	{
+		++scale;
+	}
+
+	std::vector<std::uint32_t> labels(numNodes);
+	for (std::uint64_t i = 0; i < numNodes; ++i)
+	{
+		labels[i] = static_cast<std::uint32_t>(i);
+	}
+	if (params.mPermute)
+	{
+		for (auto i = numNodes - 1; i > 0; --i)
+		{
+			std::swap(labels[i], labels[context.index(i + 1)]);
+		}
+	}
+
+	// Quadrant thresholds on 32-bit draws: below a is (0, 0), below a + b is (0, 1), below a + b + c
+	// is (1, 0), otherwise (1, 1). The row bit is r >= a + b and the column bit is the parity of the
+	// three comparisons, so a level costs no branches; each 64-bit draw covers two levels.
+	auto threshold = [](double p) { return static_cast<std::uint32_t>(std::min(std::max(p, 0.0), 1.0) * 4294967295.0); };
+	auto thresholdA = threshold(params.mA);
+	auto thresholdAB = threshold(static_cast<double>(params.mA) + params.mB);
+	auto thresholdABC = threshold(static_cast<double>(params.mA) + params.mB + params.mC);
+	auto draw = [=, &labels](Xoshiro256 &engine, std::uint32_t &u, std::uint32_t &v) {
+		std::uint64_t head;
+		std::uint64_t tail;
+		do
+		{
+			head = 0;
+			tail = 0;
+			auto descend = [&](std::uint32_t r) {
+				auto low = static_cast<std::uint64_t>(r >= thresholdA);
+				auto row = static_cast<std::uint64_t>(r >= thresholdAB);
+				auto high = static_cast<std::uint64_t>(r >= thresholdABC);
+				head = head << 1 | row;
+				tail = tail << 1 | (low ^ row ^ high);
+			};
+			auto levels = scale;
+			for (; levels >= 2; levels -= 2)
+			{
+				auto bits = engine();
+				descend(static_cast<std::uint32_t>(bits));
+				descend(static_cast<std::uint32_t>(bits >> 32));
+			}
+			if (levels > 0)
+			{
+				descend(static_cast<std::uint32_t>(engine()));
+			}
+		} while (head >= numNodes || tail >= numNodes);
+		u = labels[head];
+		v = labels[tail];
+	};
+
+	auto key = context.fast()();
+	auto numChunks = (numEdges + kChunkSize - 1) / kChunkSize;
+	auto threads = numEdges < (1 << 16) ? 1 : numThreads();
+
+	if (!params.mDedupe)
+	{
+		emitTasks(numChunks, threads, [&](std::size_t chunk, std::vector<Edge> &edges) {
+			Xoshiro256 engine(key, chunk);
+			edges.resize(std::min<std::uint64_t>((chunk + 1) * kChunkSize, numEdges) - chunk * kChunkSize);
+			for (auto &edge : edges)
+			{
+				std::uint32_t u;
+				std::uint32_t v;
+				draw(engine, u, v);
+				edge = Edge{static_cast<int>(u), static_cast<int>(v), 0.0f, context.weight(engine())};
+			}
+			setEdgeLengths(nodes, edges);
+		}, stream);
+		return;
+	}
+
+	std::vector<std::uint64_t> keys(numEdges);
+	parallelRanges(numChunks, [&](int, std::size_t first, std::size_t last) {
+		for (auto chunk = first; chunk < last; ++chunk)
+		{
+			Xoshiro256 engine(key, chunk);
+			for (auto e = chunk * kChunkSize; e < std::min<std::uint64_t>((chunk + 1) * kChunkSize, numEdges); ++e)
+			{
+				std::uint32_t u;
+				std::uint32_t v;
+				draw(engine, u, v);
+				keys[e] = edgeKey(u, v);
+			}
+		}
+	}, threads);
+	emitDistinctEdges(context, nodes, keys, threads, stream);
+}
+
+// Stochastic block model: block b holds the next mBlockSizes[b] node indices, and each pair of nodes
+// in blocks r and s is joined independently with probability mProbabilities[r * k + s]. Only the
+// upper triangle of the k x k matrix is read.
+struct SbmParams
+{
+	std::vector<int> mBlockSizes;
+	std::vector<float> mProbabilities;
+};
+
+// k blocks of (nearly) equal size with probability inProb inside a block and outProb between blocks.
+inline SbmParams plantedPartition(int numNodes, int numBlocks, float inProb, float outProb)
+{
+	SbmParams params;
+	numBlocks = std::max(1, numBlocks);
+	for (auto b = 0; b < numBlocks; ++b)
+	{
+		params.mBlockSizes.push_back(numNodes * (b + 1) / numBlocks - numNodes * b / numBlocks);
+	}
+	params.mProbabilities.assign(numBlocks * numBlocks, outProb);
+	for (auto b = 0; b < numBlocks; ++b)
+	{
+		params.mProbabilities[b * numBlocks + b] = inProb;
+	}
+	return params;
+}
+
+// Pulls each block into its own cluster: block centres are spread evenly over the sphere of the given
+// radius (Fibonacci lattice) and every node keeps its placed position, scaled by spread, as an offset.
+inline void clusterBlocks(std::vector<Node> &nodes, const std::vector<int> &blockSizes, float radius, float spread)
+{
+	auto numBlocks = static_cast<int>(blockSizes.size());
+	std::size_t first = 0;
+	for (auto b = 0; b < numBlocks; ++b)
+	{
+		auto height = numBlocks == 1 ? 0.0f : 1.0f - 2.0f * b / (numBlocks - 1);
+		auto ring = std::sqrt(std::max(0.0f, 1.0f - height * height));
+		auto angle = static_cast<float>(b) * 2.39996323f;
+		auto centre = ofVec3f(ring * std::cos(angle), ring * std::sin(angle), height) * (numBlocks == 1 ? 0.0f : radius);
+		auto last = std::min(first + blockSizes[b], nodes.size());
+		for (auto i = first; i < last; ++i)
+		{
+			nodes[i].mPosition = centre + nodes[i].mPosition * spread;
+		}
+		first = last;
+	}
+}
+
+// Independent Batagelj-Brandes skip sampling over the node pairs of every block pair, O(n + m) in
+// total. Each block pair's pair space is cut into tasks of about kEdgesPerTask expected edges (the
+// memoryless skips make the cuts exact), each task drawing from its own engine stream, so dense
+// blocks still spread over threads; emitTasks runs them and emits in task order.
+inline void streamStochasticBlockModel(GeneratorContext &context, const std::vector<Node> &nodes, const SbmParams &params, EdgeStream &stream)
+{
+	constexpr double kEdgesPerTask = 1 << 16;
+
+	struct Task
+	{
+		int mRow;
+		int mColumn;
+		std::uint64_t mFirst;
+		std::uint64_t mLast;
+	};
+
+	auto numBlocks = static_cast<int>(params.mBlockSizes.size());
+	if (params.mProbabilities.size() != static_cast<std::size_t>(numBlocks) * numBlocks)
+	{
+		throw std::runtime_error("block probability matrix must be " + std::to_string(numBlocks) + " x " + std::to_string(numBlocks));
+	}
+	std::vector<std::uint64_t> offsets(numBlocks + 1, 0);
+	for (auto b = 0; b < numBlocks; ++b)
+	{
+		offsets[b + 1] = offsets[b] + std::max(params.mBlockSizes[b], 0);
+	}
+	if (offsets[numBlocks] > nodes.size())
+	{
+		throw std::runtime_error("blocks hold " + std::to_string(offsets[numBlocks]) + " nodes but only " + std::to_string(nodes.size()) + " are placed");
+	}
+
+	// Pair slots of block pair (r, s): t = i (i - 1) / 2 + j with j < i inside a block, t = i * |s| + j
+	// between blocks.
+	auto slots = [&](int r, int s) {
+		auto rows = offsets[r + 1] - offsets[r];
+		return r == s ? rows * (rows - 1) / 2 : rows * (offsets[s + 1] - offsets[s]);
+	};
+	std::vector<Task> tasks;
+	auto expectedEdges = 0.0;
+	for (auto r = 0; r < numBlocks; ++r)
+	{
+		for (auto s = r; s < numBlocks; ++s)
+		{
+			auto edgeProb = std::min(1.0, static_cast<double>(params.mProbabilities[r * numBlocks + s]));
+			auto total = slots(r, s);
+			if (edgeProb <= 0 || total == 0)
+			{
+				continue;
+			}
+			expectedEdges += edgeProb * total;
+			auto step = static_cast<std::uint64_t>(std::max(1.0, std::min(kEdgesPerTask / edgeProb, static_cast<double>(total))));
+			for (std::uint64_t first = 0; first < total; first += step)
+			{
+				tasks.push_back(Task{r, s, first, std::min(first + step, total)});
+			}
+		}
+	}
+
+	auto key = context.fast()();
+	auto threads = expectedEdges < (1 << 16) ? 1 : numThreads();
+	emitTasks(tasks.size(), threads, [&](std::size_t index, std::vector<Edge> &edges) {
+		const auto &task = tasks[index];
+		Xoshiro256 engine(key, index);
+		auto edgeProb = std::min(1.0, static_cast<double>(params.mProbabilities[task.mRow * numBlocks + task.mColumn]));
+		auto logComplement = std::log1p(-edgeProb);
+		auto columns = offsets[task.mColumn + 1] - offsets[task.mColumn];
+		for (auto t = task.mFirst - 1;;)
+		{
+			auto skip = edgeProb >= 1 ? 0.0 : std::floor(std::log1p(-engine.uniform()) / logComplement);
+			t += 1 + static_cast<std::uint64_t>(std::min(skip, static_cast<double>(task.mLast)));
+			if (t >= task.mLast)
+			{
+				break;
+			}
+			std::uint64_t i;
+			std::uint64_t j;
+			if (task.mRow == task.mColumn)
+			{
+				i = static_cast<std::uint64_t>((1.0 + std::sqrt(1.0 + 8.0 * static_cast<double>(t))) / 2.0);
+				while (i * (i - 1) / 2 > t)
+				{
+					--i;
+				}
+				while (i * (i + 1) / 2 <= t)
+				{
+					++i;
+				}
+				j = t - i * (i - 1) / 2 + offsets[task.mColumn];
+				i += offsets[task.mRow];
+			}
+			else
+			{
+				i = t / columns + offsets[task.mRow];
+				j = t % columns + offsets[task.mColumn];
+			}
+			auto head = static_cast<int>(i);
+			auto tail = static_cast<int>(j);
+			edges.push_back(Edge{head, tail, nodes[head].mPosition.distance(nodes[tail].mPosition), context.weight(engine())});
+		}
+	}, stream);
+}
+
+// Degree of every node, self-loops counting twice; the degree sequence of the current graph.
+inline std::vector<int> degreeSequence(int numNodes, const std::vector<Edge> &edges)
+{
+	std::vector<int> degrees(numNodes, 0);
+	for (const auto &edge : edges)
+	{
+		++degrees[edge.mHead];
+		++degrees[edge.mTail];
+	}
+	return degrees;
+}
+
+// Chung-Lu expected-degree model: nodes u and v are joined with probability min(1, w_u w_v / S), S the
+// weight sum, so node u's expected degree is about w_u. O(n + m) as in Miller & Hagberg (2011): with
+// nodes sorted by weight, descending, the probability only falls along row u, so a geometric skip at
+// the current probability p followed by acceptance with q / p visits O(1) pairs per edge. Rows are cut
+// into tasks of about kEdgesPerTask expected edges for emitTasks.
+inline void streamChungLu(GeneratorContext &context, const std::vector<Node> &nodes, const std::vector<float> &weights, EdgeStream &stream)
+{
+	constexpr double kEdgesPerTask = 1 << 16;
+
+	auto numNodes = weights.size();
+	if (numNodes > nodes.size())
+	{
+		throw std::runtime_error("degree sequence has " + std::to_string(numNodes) + " entries but only " + std::to_string(nodes.size()) + " nodes are placed");
+	}
+	std::vector<int> order(numNodes);
+	for (std::size_t i = 0; i < numNodes; ++i)
+	{
+		order[i] = static_cast<int>(i);
+	}
+	parallelSort(order.begin(), order.end(), [&](int a, int b) { return weights[a] > weights[b] || (weights[a] == weights[b] && a < b); });
+	std::vector<double> sorted(numNodes);
+	auto total = 0.0;
+	for (std::size_t i = 0; i < numNodes; ++i)
+	{
+		sorted[i] = std::max(0.0f, weights[order[i]]);
+		total += sorted[i];
+	}
+	if (total <= 0)
+	{
+		stream.flush();
+		return;
+	}
+
+	std::vector<std::size_t> rows = {0};
+	auto rowWeight = 0.0;
+	for (std::size_t u = 0; u < numNodes; ++u)
+	{
+		rowWeight += sorted[u];
+		if (rowWeight >= kEdgesPerTask)
+		{
+			rows.push_back(u + 1);
+			rowWeight = 0;
+		}
+	}
+	if (rows.back() != numNodes)
+	{
+		rows.push_back(numNodes);
+	}
+
+	auto key = context.fast()();
+	auto threads = total / 2 < (1 << 16) ? 1 : numThreads();
+	emitTasks(rows.size() - 1, threads, [&](std::size_t task, std::vector<Edge> &edges) {
+		Xoshiro256 engine(key, task);
+		for (auto u = rows[task]; u < rows[task + 1] && sorted[u] > 0; ++u)
+		{
+			auto v = u + 1;
+			auto edgeProb = v < numNodes ? std::min(sorted[u] * sorted[v] / total, 1.0) : 0.0;
+			// Weights repeat a lot in real degree sequences, so the logarithm is only redone on change.
+			auto logComplement = std::log1p(-edgeProb);
+			while (v < numNodes && edgeProb > 0)
+			{
+				if (edgeProb < 1)
+				{
+					auto skip = std::floor(std::log1p(-engine.uniform()) / logComplement);
+					v += static_cast<std::size_t>(std::min(skip, static_cast<double>(numNodes)));
+				}
+				if (v < numNodes)
+				{
+					auto nextProb = std::min(sorted[u] * sorted[v] / total, 1.0);
+					if (engine.uniform() * edgeProb < nextProb)
+					{
+						edges.push_back(Edge{order[u], order[v], 0.0f, context.weight(engine())});
+					}
+					if (nextProb != edgeProb)
+					{
+						edgeProb = nextProb;
+						logComplement = std::log1p(-edgeProb);
+					}
+					++v;
+				}
+			}
+		}
+		setEdgeLengths(nodes, edges);
+	}, stream);
+}
+
+// Configuration model: node i gets degrees[i] stubs, the stubs are shuffled and paired off in order,
+// so every node keeps its degree exactly (an odd total drops one stub). The shuffle is a parallel sort
+// on random 64-bit keys drawn per fixed chunk of stubs. With erase, self-loops and repeated edges are
+// dropped through emitDistinctEdges (the erased configuration model), which trims hub degrees slightly.
+inline void streamConfigurationModel(GeneratorContext &context, const std::vector<Node> &nodes, const std::vector<int> &degrees, bool erase, EdgeStream &stream)
+{
+	constexpr std::size_t kChunkSize = 1 << 16;
+
+	struct Stub
+	{
+		std::uint64_t mKey;
+		int mNode;
+	};
+
+	auto numNodes = degrees.size();
+	if (numNodes > nodes.size())
+	{
+		throw std::runtime_error("degree sequence has " + std::to_string(numNodes) + " entries but only " + std::to_string(nodes.size()) + " nodes are placed");
+	}
+	std::vector<std::size_t> offsets(numNodes + 1, 0);
+	for (std::size_t i = 0; i < numNodes; ++i)
+	{
+		offsets[i + 1] = offsets[i] + std::max(degrees[i], 0);
+	}
+	auto numStubs = offsets[numNodes];
+	auto numEdges = numStubs / 2;
+	auto threads = numEdges < (1 << 16) ? 1 : numThreads();
+
+	std::vector<Stub> stubs(numStubs);
+	parallelRanges(numNodes, [&](int, std::size_t first, std::size_t last) {
+		for (auto i = first; i < last; ++i)
+		{
+			for (auto stub = offsets[i]; stub < offsets[i + 1]; ++stub)
+			{
+				stubs[stub].mNode = static_cast<int>(i);
+			}
+		}
+	}, threads);
+	auto key = context.fast()();
+	auto numChunks = (numStubs + kChunkSize - 1) / kChunkSize;
+	parallelRanges(numChunks, [&](int, std::size_t first, std::size_t last) {
+		for (auto chunk = first; chunk < last; ++chunk)
+		{
+			Xoshiro256 engine(key, chunk);
+			for (auto stub = chunk * kChunkSize; stub < std::min((chunk + 1) * kChunkSize, numStubs); ++stub)
+			{
+				stubs[stub].mKey = engine();
+			}
+		}
+	}, threads);
+	parallelSort(stubs.begin(), stubs.end(), [](const Stub &a, const Stub &b) { return a.mKey < b.mKey || (a.mKey == b.mKey && a.mNode < b.mNode); }, threads);
+
+	if (erase)
+	{
+		std::vector<std::uint64_t> keys(numEdges);
+		parallelRanges(numEdges, [&](int, std::size_t first, std::size_t last) {
+			for (auto e = first; e < last; ++e)
+			{
+				keys[e] = edgeKey(stubs[2 * e].mNode, stubs[2 * e + 1].mNode);
+			}
+		}, threads);
+		std::vector<Stub>().swap(stubs);
+		emitDistinctEdges(context, nodes, keys, threads, stream);
+		return;
+	}
+
+	// Weights come from a second key, so they are independent of the shuffle.
+	auto weightKey = context.fast()();
+	emitTasks((numEdges + kChunkSize - 1) / kChunkSize, threads, [&](std::size_t chunk, std::vector<Edge> &edges) {
+		Xoshiro256 engine(weightKey, chunk);
+		for (auto e = chunk * kChunkSize; e < std::min((chunk + 1) * kChunkSize, numEdges); ++e)
+		{
+			edges.push_back(Edge{stubs[2 * e].mNode, stubs[2 * e + 1].mNode, 0.0f, context.weight(engine())});
+		}
+		setEdgeLengths(nodes, edges);
+	}, stream);
+}
+
+struct GeometricParams
+{
+	float mRadius = 30.0f;
+	// Distances wrap on every axis (a 3-torus), so nodes near one face connect to nodes near the opposite
+	// face.
+	bool mPeriodic = false;
+	// Side of the periodic cube; 0 takes the cube the placement fills, 2 (radiusMean + 3 radiusStd). The
+	// nodes' own bounding cube would be too tight: the extreme nodes on an axis would wrap onto each
+	// other and always connect. A side no larger than the nodes' extent is widened to extent + mRadius.
+	float mPeriod = 0.0f;
+};
+
+// Random geometric graph: every pair of nodes closer than mRadius is joined. Nodes are binned into a
+// UniformGrid with cells at least mRadius wide, so each node only tests the 27 cells around its own
+// and the cost is O(n + m). With periodic boundaries the periodic cube, anchored at the nodes' lowest
+// corner, is cut into a whole number of cells per axis and neighbour cells wrap. The sweep runs over the grid's bucket order in emitTasks
+// chunks, each edge found from its lower endpoint. Lengths stay the plain distance between the
+// placed nodes, as for every generator, so the springs start at rest.
+inline void streamRandomGeometric(GeneratorContext &context, const std::vector<Node> &nodes, const GeometricParams &params, EdgeStream &stream)
+{
+	constexpr std::size_t kChunkSize = 4096;
+
+	auto numNodes = nodes.size();
+	if (numNodes < 2 || params.mRadius <= 0)
+	{
+		stream.flush();
+		return;
+	}
+
+	ofVec3f low = nodes[0].mPosition;
+	auto extent = 0.0f;
+	for (const auto &node : nodes)
+	{
+		for (auto axis = 0; axis < 3; ++axis)
+		{
+			low[axis] = std::min(low[axis], node.mPosition[axis]);
+		}
+	}
+	for (const auto &node : nodes)
+	{
+		for (auto axis = 0; axis < 3; ++axis)
+		{
+			extent = std::max(extent, node.mPosition[axis] - low[axis]);
+		}
+	}
+
+	// Periodic cells: a whole number of them per side, each a hair wider than side / cells so that
+	// rounding never puts a point into cell `cells`.
+	auto period = params.mPeriod > 0 ? params.mPeriod : 2 * (context.params().mRadiusMean + 3 * context.params().mRadiusStd);
+	auto side = std::max(period > extent ? period : extent + params.mRadius, params.mRadius);
+	auto cells = params.mPeriodic ? std::max(1, static_cast<int>(side / params.mRadius)) : 0;
+	auto cellSize = params.mPeriodic ? side / cells * (1 + 1e-5f) : params.mRadius;
+	auto threads = numNodes < (1 << 14) ? 1 : numThreads();
+
+	UniformGrid grid;
+	grid.build(numNodes, cellSize, [&](std::size_t i) { return nodes[i].mPosition - low; });
+
+	auto radiusSquared = params.mRadius * params.mRadius;
+	auto halfSide = side / 2;
+	auto key = context.fast()();
+	emitTasks((numNodes + kChunkSize - 1) / kChunkSize, threads, [&](std::size_t chunk, std::vector<Edge> &edges) {
+		Xoshiro256 engine(key, chunk);
+		// Points come in bucket order, so the neighbour buckets are only recomputed when the cell changes.
+		int cell[3] = {0, 0, 0};
+		std::size_t buckets[27];
+		auto numBuckets = -1;
+		for (auto k = chunk * kChunkSize; k < std::min((chunk + 1) * kChunkSize, numNodes); ++k)
+		{
+			auto i = grid.index(k);
+			const auto &position = grid.point(k);
+			int pointCell[3] = {grid.cell(position.x), grid.cell(position.y), grid.cell(position.z)};
+			if (numBuckets < 0 || !std::equal(pointCell, pointCell + 3, cell))
+			{
+				std::copy(pointCell, pointCell + 3, cell);
+				std::size_t around[27];
+				for (auto neighbor = 0; neighbor < 27; ++neighbor)
+				{
+					int offset[3] = {neighbor % 3 - 1, neighbor / 3 % 3 - 1, neighbor / 9 - 1};
+					for (auto axis = 0; axis < 3; ++axis)
+					{
+						offset[axis] += cell[axis];
+						if (params.mPeriodic)
+						{
+							offset[axis] = (offset[axis] + cells) % cells;
+						}
+					}
+					around[neighbor] = grid.bucket(offset[0], offset[1], offset[2]);
+				}
+				numBuckets = grid.occupiedBuckets(around, 27, buckets);
+			}
+			for (auto b = 0; b < numBuckets; ++b)
+			{
+				grid.forEachInBucket(buckets[b], [&](int j, const ofVec3f &point) {
+					if (j <= i)
+					{
+						return;
+					}
+					auto delta = point - position;
+					if (params.mPeriodic)
+					{
+						for (auto axis = 0; axis < 3; ++axis)
+						{
+							delta[axis] += delta[axis] > halfSide ? -side : delta[axis] < -halfSide ? side : 0.0f;
+						}
+					}
+					if (delta.lengthSquared() < radiusSquared)
+					{
+						edges.push_back(Edge{i, j, 0.0f, context.weight(engine())});
+					}
+				});
+			}
+		}
+		setEdgeLengths(nodes, edges);
+	}, stream);
+}
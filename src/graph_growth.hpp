@@ -0,0 +1,189 @@
+#pragma once
+
+#include "dynamic_graph.hpp"
+#include "graph.hpp"
+#include "graph_generator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Rates are per step and may be fractional: the remainder carries over, so 0.25 adds a node every
+// fourth frame.
+struct GrowthParams
+{
+	// New nodes, each attached to mEdgesPerNode distinct existing nodes chosen in proportion to degree
+	// (Barabasi-Albert growth). Growth stops at mMaxNodes nodes.
+	float mNodesPerStep = 1.0f;
+	int mEdgesPerNode = 2;
+	int mMaxNodes = 5000;
+	// Edges whose tail moves to a uniformly random node (Watts-Strogatz rewiring).
+	float mRewiresPerStep = 0.0f;
+	// Edges removed, each replaced by a uniformly random new edge (Erdos-Renyi churn).
+	float mChurnPerStep = 0.0f;
+	// New nodes start within this distance of their first target instead of on the placement sphere.
+	float mSpawnRadius = 1.0f;
+};
+
+struct GrowthDelta
+{
+	int mAddedNodes = 0;
+	int mAddedEdges = 0;
+	int mRemovedEdges = 0;
+
+	bool empty() const { return mAddedNodes == 0 && mAddedEdges == 0 && mRemovedEdges == 0; }
+};
+
+// Evolves a graph in place through its DynamicGraph index, one frame at a time, with work proportional
+// to the changes. Preferential attachment picks a random end of a random edge, which is
+// degree-proportional with no extra structure. Existing nodes are never touched, so their physics
+// state carries on.
+class GraphGrowth
+{
+public:
+	// Call again whenever the graph is replaced wholesale.
+	void reset(std::mt19937 &engine, const DynamicGraph &graph)
+	{
+		mEngine = Xoshiro256(engine);
+		mDegreeCounts.assign(1, 0);
+		mMaxDegree = 0;
+		for (auto u = 0; u < graph.numNodes(); ++u)
+		{
+			changeDegree(-1, graph.degree(u));
+		}
+		mNodeCredit = 0;
+		mRewireCredit = 0;
+		mChurnCredit = 0;
+	}
+
+	GrowthDelta step(std::vector<Node> &nodes, DynamicGraph &graph, const GrowthParams &params, const GeneratorParams &generator)
+	{
+		constexpr int kMaxAttempts = 32;
+
+		GrowthDelta delta;
+		auto numEdges = [&] { return graph.numEdges(); };
+		auto weight = [&] { return generator.mEdgeWeightMin + (generator.mEdgeWeightMax - generator.mEdgeWeightMin) * static_cast<float>(mEngine.uniform()); };
+		auto addEdge = [&](int head, int tail, float edgeWeight) {
+			if (head == tail || graph.contains(head, tail))
+			{
+				return false;
+			}
+			graph.addEdge(Edge{head, tail, nodes[head].mPosition.distance(nodes[tail].mPosition), edgeWeight});
+			changeDegree(graph.degree(head) - 1, graph.degree(head));
+			changeDegree(graph.degree(tail) - 1, graph.degree(tail));
+			++delta.mAddedEdges;
+			return true;
+		};
+		auto removeEdge = [&](std::size_t position) {
+			auto edge = graph.edge(graph.id(position));
+			graph.removeEdge(graph.id(position));
+			if (edge.mHead == edge.mTail)
+			{
+				changeDegree(graph.degree(edge.mHead) + 2, graph.degree(edge.mHead));
+			}
+			else
+			{
+				changeDegree(graph.degree(edge.mHead) + 1, graph.degree(edge.mHead));
+				changeDegree(graph.degree(edge.mTail) + 1, graph.degree(edge.mTail));
+			}
+			++delta.mRemovedEdges;
+			return edge;
+		};
+		auto randomEdge = [&] { return graph.edge(graph.id(mEngine.index(numEdges()))); };
+		auto randomNode = [&] { return static_cast<int>(mEngine.index(nodes.size())); };
+
+		for (mNodeCredit += params.mNodesPerStep; mNodeCredit >= 1 && static_cast<int>(nodes.size()) < params.mMaxNodes; mNodeCredit -= 1)
+		{
+			// Targets are drawn before the node exists, so it cannot pick itself.
+			auto numTargets = std::min<std::size_t>(std::max(params.mEdgesPerNode, 0), nodes.size());
+			std::vector<int> targets;
+			for (auto attempt = 0; targets.size() < numTargets && attempt < kMaxAttempts * static_cast<int>(numTargets); ++attempt)
+			{
+				auto target = randomNode();
+				if (numEdges() > 0)
+				{
+					const auto &edge = randomEdge();
+					target = mEngine() & 1 ? edge.mHead : edge.mTail;
+				}
+				if (std::find(targets.begin(), targets.end(), target) == targets.end())
+				{
+					targets.push_back(target);
+				}
+			}
+
+			ofVec3f position;
+			if (!targets.empty())
+			{
+				auto direction = ofVec3f(static_cast<float>(mEngine.uniform()) - 0.5f, static_cast<float>(mEngine.uniform()) - 0.5f, static_cast<float>(mEngine.uniform()) - 0.5f);
+				position = nodes[targets[0]].mPosition + direction.getNormalized() * params.mSpawnRadius;
+			}
+			nodes.push_back(Node{position});
+			graph.addNode();
+			changeDegree(-1, 0);
+			++delta.mAddedNodes;
+			for (auto target : targets)
+			{
+				addEdge(static_cast<int>(nodes.size()) - 1, target, weight());
+			}
+		}
+		mNodeCredit = std::min(mNodeCredit, 1.0f);
+
+		for (mRewireCredit += params.mRewiresPerStep; mRewireCredit >= 1 && numEdges() > 0; mRewireCredit -= 1)
+		{
+			auto e = mEngine.index(numEdges());
+			auto head = graph.edge(graph.id(e)).mHead;
+			for (auto attempt = 0; attempt < kMaxAttempts; ++attempt)
+			{
+				auto tail = randomNode();
+				if (tail != head && !graph.contains(head, tail))
+				{
+					auto old = removeEdge(e);
+					addEdge(head, tail, old.mWeight);
+					break;
+				}
+			}
+		}
+
+		for (mChurnCredit += params.mChurnPerStep; mChurnCredit >= 1 && numEdges() > 0 && nodes.size() > 1; mChurnCredit -= 1)
+		{
+			removeEdge(mEngine.index(numEdges()));
+			for (auto attempt = 0; attempt < kMaxAttempts && !addEdge(randomNode(), randomNode(), weight()); ++attempt)
+			{
+			}
+		}
+		mRewireCredit = std::min(mRewireCredit, 1.0f);
+		mChurnCredit = std::min(mChurnCredit, 1.0f);
+		return delta;
+	}
+
+	int maxDegree() const { return mMaxDegree; }
+
+private:
+	// A histogram of degrees keeps the maximum exact under removals, in O(1) amortised. A node moves
+	// from one degree to another; -1 stands for a node that did not exist.
+	void changeDegree(int from, int degree)
+	{
+		if (from >= 0)
+		{
+			--mDegreeCounts[from];
+		}
+		if (static_cast<std::size_t>(degree) >= mDegreeCounts.size())
+		{
+			mDegreeCounts.resize(degree + 1, 0);
+		}
+		++mDegreeCounts[degree];
+		mMaxDegree = std::max(mMaxDegree, degree);
+		while (mMaxDegree > 0 && mDegreeCounts[mMaxDegree] == 0)
+		{
+			--mMaxDegree;
+		}
+	}
+
+	Xoshiro256 mEngine{0, 0};
+	std::vector<std::size_t> mDegreeCounts;
+	int mMaxDegree = 0;
+	float mNodeCredit = 0;
+	float mRewireCredit = 0;
+	float mChurnCredit = 0;
+};
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "graph_generator.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Importers fill only mHead, mTail and, when the file has one, mWeight (NaN otherwise).
+// finishImport then places nodes and derives lengths and weights like the generators do.
+struct ImportedGraph
+{
+	int mNumNodes = 0;
+	std::vector<Edge> mEdges;
+};
+
+// Whitespace separated "head tail [weight]" lines; '#' and '%' start comment lines. The mapped file is
+// cut into one newline-aligned chunk per thread, each parsed with std::from_chars into a local buffer.
+inline ImportedGraph importEdgeList(const std::string &path, int threads = numThreads())
+{
+	MappedFile file(path);
+	file.advise(MADV_SEQUENTIAL);
+	const char *data = file.data();
+	auto size = file.size();
+
+	threads = std::max(1, threads);
+	std::vector<std::vector<Edge>> chunks(threads);
+	std::vector<int> maxNodes(threads, -1);
+	std::vector<int> errors(threads, 0);
+
+	parallelRanges(size, [&](int thread, std::size_t first, std::size_t last) {
+		// A chunk owns every line that starts inside it.
+		if (first > 0)
+		{
+			auto newline = static_cast<const char *>(std::memchr(data + first - 1, '\n', size - first + 1));
+			first = newline ? newline - data + 1 : size;
+		}
+		if (last < size)
+		{
+			auto newline = static_cast<const char *>(std::memchr(data + last - 1, '\n', size - last + 1));
+			last = newline ? newline - data + 1 : size;
+		}
+
+		auto &edges = chunks[thread];
+		edges.reserve((last - first) / 12);
+		const char *cursor = data + first;
+		auto end = data + std::max(first, last);
+		auto skipBlanks = [&] {
+			while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+			{
+				++cursor;
+			}
+		};
+		auto skipLine = [&] {
+			auto newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+			cursor = newline ? newline + 1 : end;
+		};
+
+		while (cursor < end)
+		{
+			skipBlanks();
+			if (cursor == end || *cursor == '\n' || *cursor == '#' || *cursor == '%')
+			{
+				skipLine();
+				continue;
+			}
+
+			long long head = 0;
+			long long tail = 0;
+			auto result = std::from_chars(cursor, end, head);
+			cursor = result.ptr;
+			skipBlanks();
+			auto tailResult = std::from_chars(cursor, end, tail);
+			cursor = tailResult.ptr;
+			if (result.ec != std::errc() || tailResult.ec != std::errc() || head < 0 || tail < 0 || head >= INT_MAX || tail >= INT_MAX)
+			{
+				++errors[thread];
+				skipLine();
+				continue;
+			}
+
+			// A third column that is not a finite number is an error, not a missing weight.
+			auto weight = std::numeric_limits<float>::quiet_NaN();
+			skipBlanks();
+			if (cursor < end && *cursor != '\n' && *cursor != '#' && *cursor != '%')
+			{
+				auto weightResult = std::from_chars(cursor, end, weight);
+				if (weightResult.ec != std::errc() || !std::isfinite(weight))
+				{
+					++errors[thread];
+					skipLine();
+					continue;
+				}
+			}
+			skipLine();
+
+			edges.push_back(Edge{static_cast<int>(head), static_cast<int>(tail), 0, weight});
+			maxNodes[thread] = std::max<int>(maxNodes[thread], std::max(head, tail));
+		}
+	}, threads);
+
+	for (auto error : errors)
+	{
+		if (error > 0)
+		{
+			throw std::runtime_error(path + " contains malformed edge lines");
+		}
+	}
+
+	ImportedGraph graph;
+	std::vector<std::size_t> offsets(threads + 1, 0);
+	for (auto thread = 0; thread < threads; ++thread)
+	{
+		offsets[thread + 1] = offsets[thread] + chunks[thread].size();
+		graph.mNumNodes = std::max(graph.mNumNodes, maxNodes[thread] + 1);
+	}
+	graph.mEdges.resize(offsets[threads]);
+	parallelRanges(threads, [&](int, std::size_t first, std::size_t last) {
+		for (auto thread = first; thread < last; ++thread)
+		{
+			std::copy(chunks[thread].begin(), chunks[thread].end(), graph.mEdges.begin() + offsets[thread]);
+			std::vector<Edge>().swap(chunks[thread]);
+		}
+	}, threads);
+	return graph;
+}
+
+// Degree sequence for streamChungLu and streamConfigurationModel: the first number on each line is the
+// degree of the next node and the rest of the line is ignored; '#' and '%' start comment lines.
+inline std::vector<int> importDegreeSequence(const std::string &path)
+{
+	MappedFile file(path);
+	file.advise(MADV_SEQUENTIAL);
+	const char *cursor = file.data();
+	auto end = cursor + file.size();
+	std::vector<int> degrees;
+	while (cursor < end)
+	{
+		while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+		{
+			++cursor;
+		}
+		if (cursor < end && *cursor != '\n' && *cursor != '#' && *cursor != '%')
+		{
+			long long degree = 0;
+			auto result = std::from_chars(cursor, end, degree);
+			if (result.ec != std::errc() || degree < 0 || degree >= INT_MAX)
+			{
+				throw std::runtime_error(path + " contains malformed degree lines");
+			}
+			degrees.push_back(static_cast<int>(degree));
+			cursor = result.ptr;
+		}
+		auto newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+		cursor = newline ? newline + 1 : end;
+	}
+	return degrees;
+}
+
+// Minimal GraphML reader: <node id>, <edge source target> and an optional edge <data> whose <key> is named "weight".
+inline ImportedGraph importGraphML(const std::string &path)
+{
+	MappedFile file(path);
+	auto text = std::string_view(file.data(), file.size());
+
+	auto attribute = [](std::string_view tag, std::string_view name) {
+		for (auto position = tag.find(name); position != std::string_view::npos; position = tag.find(name, position + 1))
+		{
+			auto equals = position + name.size();
+			if ((position == 0 || std::isspace(static_cast<unsigned char>(tag[position - 1]))) && equals + 1 < tag.size() && tag[equals] == '=')
+			{
+				auto quote = tag[equals + 1];
+				auto close = tag.find(quote, equals + 2);
+				if (close != std::string_view::npos)
+				{
+					return tag.substr(equals + 2, close - equals - 2);
+				}
+			}
+		}
+		return std::string_view();
+	};
+
+	auto isElement = [](std::string_view tag, std::string_view name) {
+		return tag.size() > name.size() && tag.compare(0, name.size(), name) == 0 && std::isspace(static_cast<unsigned char>(tag[name.size()]));
+	};
+
+	ImportedGraph graph;
+	std::unordered_map<std::string_view, int> ids;
+	auto nodeId = [&](std::string_view id) {
+		auto inserted = ids.emplace(id, graph.mNumNodes);
+		if (inserted.second)
+		{
+			++graph.mNumNodes;
+		}
+		return inserted.first->second;
+	};
+
+	std::string_view weightKey;
+	for (auto position = text.find('<'); position != std::string_view::npos; position = text.find('<', position + 1))
+	{
+		auto close = text.find('>', position);
+		if (close == std::string_view::npos)
+		{
+			break;
+		}
+		auto tag = text.substr(position + 1, close - position - 1);
+
+		if (isElement(tag, "key") && attribute(tag, "attr.name") == "weight")
+		{
+			weightKey = attribute(tag, "id");
+		}
+		else if (isElement(tag, "node"))
+		{
+			nodeId(attribute(tag, "id"));
+		}
+		else if (isElement(tag, "edge"))
+		{
+			auto head = nodeId(attribute(tag, "source"));
+			auto tail = nodeId(attribute(tag, "target"));
+			auto weight = std::numeric_limits<float>::quiet_NaN();
+
+			auto last = tag.back() == '/' ? close : text.find("</edge>", close);
+			for (auto data = text.find("<data", close); !weightKey.empty() && data < last; data = text.find("<data", data + 1))
+			{
+				auto dataClose = text.find('>', data);
+				if (attribute(text.substr(data + 1, dataClose - data - 1), "key") == weightKey)
+				{
+					auto value = text.find_first_not_of(" \t\r\n", dataClose + 1);
+					auto result = std::from_chars(text.data() + std::min(value, text.size()), text.data() + text.size(), weight);
+					if (result.ec != std::errc() || !std::isfinite(weight))
+					{
+						throw std::runtime_error(path + " has an edge weight that is not a number");
+					}
+					break;
+				}
+			}
+			graph.mEdges.push_back(Edge{head, tail, 0, weight});
+		}
+		position = close;
+	}
+	return graph;
+}
+
+// Places the imported nodes with generateNode and rescales file weights into [edgeWeightMin, edgeWeightMax];
+// edges without a weight get a uniform one, as generated edges do. When every file weight is the same
+// (typically all 1) they map to the middle of the range rather than to edgeWeightMin, which defaults to
+// 0 and would leave every spring inert.
+inline void finishImport(std::mt19937 &engine, ImportedGraph &graph, float radiusMean, float radiusStd, float edgeWeightMin, float edgeWeightMax, std::vector<Node> &nodes, std::vector<Edge> &edges)
+{
+	generateNodes(engine, nodes, graph.mNumNodes, radiusMean, radiusStd);
+
+	auto minWeight = std::numeric_limits<float>::infinity();
+	auto maxWeight = -std::numeric_limits<float>::infinity();
+	for (const auto &edge : graph.mEdges)
+	{
+		if (!std::isnan(edge.mWeight))
+		{
+			minWeight = std::min(minWeight, edge.mWeight);
+			maxWeight = std::max(maxWeight, edge.mWeight);
+		}
+	}
+	auto scale = maxWeight > minWeight ? (edgeWeightMax - edgeWeightMin) / (maxWeight - minWeight) : 0.0f;
+	auto offset = maxWeight > minWeight ? edgeWeightMin : 0.5f * (edgeWeightMin + edgeWeightMax);
+
+	auto weights = std::uniform_real_distribution<float>(edgeWeightMin, edgeWeightMax);
+	for (auto &edge : graph.mEdges)
+	{
+		edge.mWeight = std::isnan(edge.mWeight) ? weights(engine) : offset + (edge.mWeight - minWeight) * scale;
+	}
+	parallelFor(graph.mEdges.size(), [&](std::size_t i) {
+		auto &edge = graph.mEdges[i];
+		edge.mLength = nodes[edge.mHead].mPosition.distance(nodes[edge.mTail].mPosition);
+	});
+
+	edges = std::move(graph.mEdges);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "bfs.hpp"
+#include "csr_graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+struct GraphStats
+{
+	std::vector<std::size_t> mDegreeHistogram;
+	double mMeanDegree = 0;
+	int mMaxDegree = 0;
+	double mGlobalClustering = 0;
+	double mAverageClustering = 0;
+	double mAveragePathLength = 0;
+	int mNumPathSources = 0;
+	int mDiameter = 0;
+};
+
+// Number of triangles through every node, by merging sorted neighbour lists: for each neighbour v of u,
+// |N(u) ∩ N(v)| restricted to w > v counts each neighbour pair of u exactly once.
+inline std::vector<std::int64_t> countTriangles(const CsrGraph &graph)
+{
+	std::vector<std::int64_t> triangles(graph.numNodes(), 0);
+	parallelFor(graph.numNodes(), [&](std::size_t u) {
+		std::int64_t count = 0;
+		for (auto v = graph.begin(u); v != graph.end(u); ++v)
+		{
+			auto first = std::upper_bound(graph.begin(u), graph.end(u), *v);
+			auto second = std::upper_bound(graph.begin(*v), graph.end(*v), *v);
+			while (first != graph.end(u) && second != graph.end(*v))
+			{
+				if (*first < *second)
+				{
+					++first;
+				}
+				else if (*second < *first)
+				{
+					++second;
+				}
+				else
+				{
+					++count;
+					++first;
+					++second;
+				}
+			}
+		}
+		triangles[u] = count;
+	});
+	return triangles;
+}
+
+// Mean shortest path length over reachable pairs, from numSources random roots (all nodes when
+// numSources >= n, which makes it exact). Roots go through the bit-parallel BFS 64 at a time; the
+// largest eccentricity seen is a lower bound on the diameter.
+inline double averagePathLength(const CsrGraph &graph, int numSources, std::mt19937 &engine, int *numUsedSources = nullptr, int *maxEccentricity = nullptr)
+{
+	auto numNodes = graph.numNodes();
+	std::vector<int> sources(numNodes);
+	std::iota(sources.begin(), sources.end(), 0);
+	if (numSources < numNodes)
+	{
+		std::shuffle(sources.begin(), sources.end(), engine);
+		sources.resize(std::max(numSources, 0));
+	}
+	if (numUsedSources)
+	{
+		*numUsedSources = sources.size();
+	}
+
+	double total = 0;
+	std::int64_t numPairs = 0;
+	auto eccentricity = 0;
+	for (std::size_t first = 0; first < sources.size(); first += 64)
+	{
+		auto batch = multiSourceBfs(graph, sources.data() + first, std::min<std::size_t>(64, sources.size() - first));
+		for (auto s = 0; s < batch.mNumSources; ++s)
+		{
+			total += batch.mDistanceSums[s];
+			numPairs += batch.mNumReached[s];
+			eccentricity = std::max(eccentricity, batch.mEccentricities[s]);
+		}
+	}
+	if (maxEccentricity)
+	{
+		*maxEccentricity = eccentricity;
+	}
+	return numPairs > 0 ? total / numPairs : 0.0;
+}
+
+inline GraphStats computeGraphStats(const CsrGraph &graph, int numPathSources, std::mt19937 &engine)
+{
+	GraphStats stats;
+	auto numNodes = graph.numNodes();
+	if (numNodes <= 0)
+	{
+		return stats;
+	}
+
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		stats.mMaxDegree = std::max(stats.mMaxDegree, graph.degree(i));
+	}
+	stats.mDegreeHistogram.assign(stats.mMaxDegree + 1, 0);
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		++stats.mDegreeHistogram[graph.degree(i)];
+	}
+	stats.mMeanDegree = static_cast<double>(graph.numArcs()) / numNodes;
+
+	auto triangles = countTriangles(graph);
+	double closedTriples = 0;
+	double connectedTriples = 0;
+	double localSum = 0;
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		auto degree = static_cast<double>(graph.degree(i));
+		auto triples = degree * (degree - 1) / 2;
+		closedTriples += triangles[i];
+		connectedTriples += triples;
+		localSum += triples > 0 ? triangles[i] / triples : 0.0;
+	}
+	stats.mGlobalClustering = connectedTriples > 0 ? closedTriples / connectedTriples : 0.0;
+	stats.mAverageClustering = localSum / numNodes;
+
+	stats.mAveragePathLength = averagePathLength(graph, numPathSources, engine, &stats.mNumPathSources, &stats.mDiameter);
+	auto start = std::uniform_int_distribution<int>(0, numNodes - 1)(engine);
+	stats.mDiameter = std::max(stats.mDiameter, estimateDiameter(graph, start));
+	return stats;
+}
@@ -1,8 +1,45 @@
 #include "ofMain.h"
 #include "random_graph.hpp"
 
-int main()
+// RandomGraph [graph]                  open the viewer on a graph file
+// RandomGraph --export <out> [graph]   write the initial graph to <out> without opening a window; exits
+//                                      with 1 when the graph cannot be loaded or written. <out> is used
+//                                      as given, not relative to the data folder.
+int main(int argc, char *argv[])
 {
+	if (argc > 2 && std::string(argv[1]) == "--export")
+	{
+		RandomGraph app;
+		if (argc > 3)
+		{
+			app.mGraphPath = argv[3];
+			if (!ofFile::doesFileExist(app.mGraphPath))
+			{
+				ofLogError("RandomGraph") << "cannot open " << app.mGraphPath;
+				return 1;
+			}
+		}
+		if (!app.setupGraph())
+		{
+			return 1;
+		}
+		try
+		{
+			exportGraph(argv[2], app.mNodes, app.mEdges);
+		}
+		catch (const std::exception &error)
+		{
+			ofLogError("RandomGraph") << error.what();
+			return 1;
+		}
+		return 0;
+	}
+
+	auto app = new RandomGraph();
+	if (argc > 1)
+	{
+		app->mGraphPath = argv[1];
+	}
 	ofSetupOpenGL(1024, 768, OF_WINDOW);
-	ofRunApp(new RandomGraph());
+	ofRunApp(app);
 }
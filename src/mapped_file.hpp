@@ -0,0 +1,64 @@
+#pragma once
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Private, writable mapping of a whole file. Writes stay in memory and never reach the file.
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string &path)
+	{
+		auto fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("cannot open " + path);
+		}
+		struct stat status;
+		if (::fstat(fd, &status) != 0)
+		{
+			::close(fd);
+			throw std::runtime_error("cannot stat " + path);
+		}
+		mSize = status.st_size;
+		if (mSize > 0)
+		{
+			mData = ::mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd);
+		if (mData == MAP_FAILED)
+		{
+			throw std::runtime_error("cannot map " + path);
+		}
+	}
+
+	~MappedFile()
+	{
+		if (mSize > 0)
+		{
+			::munmap(mData, mSize);
+		}
+	}
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	void advise(int advice) const
+	{
+		if (mSize > 0)
+		{
+			::madvise(mData, mSize, advice);
+		}
+	}
+
+	char *data() const { return static_cast<char *>(mData); }
+	std::size_t size() const { return mSize; }
+
+private:
+	void *mData = nullptr;
+	std::size_t mSize = 0;
+};
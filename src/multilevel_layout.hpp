@@ -0,0 +1,222 @@
+#pragma once
+
+#include "barnes_hut.hpp"
+#include "csr_graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+struct MultilevelParams
+{
+	int mCoarsestSize = 64;
+	int mIterations = 100;
+	int mMinIterations = 10;
+	float mRepulsion = 1.0f;
+	float mTheta = 1.0f;
+};
+
+// One level of the hierarchy: a weighted adjacency with rest lengths, node masses (number of original
+// nodes collapsed into each) and, except on the coarsest level, the coarse node of every node.
+struct LayoutLevel
+{
+	int mNumNodes = 0;
+	std::vector<std::size_t> mOffsets;
+	std::vector<int> mNeighbors;
+	std::vector<float> mLengths;
+	std::vector<float> mWeights;
+	std::vector<float> mMasses;
+	std::vector<int> mParents;
+
+	// Parallel edges are merged: rest lengths averaged, stiffnesses summed.
+	void assign(int numNodes, std::vector<Edge> edges)
+	{
+		mNumNodes = numNodes;
+		edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge &edge) { return edge.mHead == edge.mTail; }), edges.end());
+		auto numEdges = edges.size();
+		for (std::size_t i = 0; i < numEdges; ++i)
+		{
+			auto reverse = edges[i];
+			std::swap(reverse.mHead, reverse.mTail);
+			edges.push_back(reverse);
+		}
+		std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) { return a.mHead != b.mHead ? a.mHead < b.mHead : a.mTail < b.mTail; });
+
+		mOffsets.assign(numNodes + 1, 0);
+		mNeighbors.clear();
+		mLengths.clear();
+		mWeights.clear();
+		for (std::size_t i = 0; i < edges.size();)
+		{
+			auto j = i;
+			auto length = 0.0f;
+			auto weight = 0.0f;
+			for (; j < edges.size() && edges[j].mHead == edges[i].mHead && edges[j].mTail == edges[i].mTail; ++j)
+			{
+				length += edges[j].mLength;
+				weight += edges[j].mWeight;
+			}
+			mNeighbors.push_back(edges[i].mTail);
+			mLengths.push_back(length / (j - i));
+			mWeights.push_back(weight);
+			++mOffsets[edges[i].mHead + 1];
+			i = j;
+		}
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			mOffsets[i + 1] += mOffsets[i];
+		}
+	}
+};
+
+// Random maximal matching. A node left without an unmatched neighbour joins the group of one of its
+// (necessarily matched) neighbours, so stars such as BA hubs collapse instead of stalling the hierarchy.
+inline LayoutLevel coarsen(LayoutLevel &level, std::mt19937 &engine)
+{
+	std::vector<int> order(level.mNumNodes);
+	std::iota(order.begin(), order.end(), 0);
+	std::shuffle(order.begin(), order.end(), engine);
+
+	auto &parents = level.mParents;
+	parents.assign(level.mNumNodes, -1);
+	auto numCoarse = 0;
+	std::vector<int> unmatched;
+	for (auto u : order)
+	{
+		if (parents[u] >= 0)
+		{
+			continue;
+		}
+		for (auto k = level.mOffsets[u]; k < level.mOffsets[u + 1]; ++k)
+		{
+			if (parents[level.mNeighbors[k]] < 0)
+			{
+				parents[u] = parents[level.mNeighbors[k]] = numCoarse++;
+				break;
+			}
+		}
+		if (parents[u] < 0)
+		{
+			unmatched.push_back(u);
+		}
+	}
+	for (auto u : unmatched)
+	{
+		parents[u] = level.mOffsets[u] < level.mOffsets[u + 1] ? parents[level.mNeighbors[level.mOffsets[u]]] : numCoarse++;
+	}
+
+	LayoutLevel coarse;
+	coarse.mMasses.assign(numCoarse, 0.0f);
+	for (auto u = 0; u < level.mNumNodes; ++u)
+	{
+		coarse.mMasses[parents[u]] += level.mMasses[u];
+	}
+	std::vector<Edge> edges;
+	for (auto u = 0; u < level.mNumNodes; ++u)
+	{
+		for (auto k = level.mOffsets[u]; k < level.mOffsets[u + 1]; ++k)
+		{
+			auto v = level.mNeighbors[k];
+			if (u < v && parents[u] != parents[v])
+			{
+				edges.push_back(Edge{parents[u], parents[v], level.mLengths[k], level.mWeights[k]});
+			}
+		}
+	}
+	coarse.assign(numCoarse, std::move(edges));
+	return coarse;
+}
+
+// Springs on the level's edges (stiffness times stretch, as in RandomGraph::updateSprings, with
+// stiffness normalised to mean 1) plus Barnes-Hut repulsion between masses, integrated with a cooling
+// step limit. Repulsion is scaled so that the equilibrium radius grows like restLength * n^(1/3).
+// Forces are pulled per node, so the sweep is parallel without atomics.
+inline void relaxLevel(const LayoutLevel &level, std::vector<ofVec3f> &positions, const MultilevelParams &params, int numIterations, float restLength, float meanWeight, float meanDegree, float totalMass)
+{
+	BarnesHutTree tree;
+	std::vector<ofVec3f> forces(level.mNumNodes);
+	auto strength = params.mRepulsion * meanDegree * restLength * restLength / std::cbrt(totalMass);
+	for (auto iteration = 0; iteration < numIterations; ++iteration)
+	{
+		tree.build(positions, level.mMasses);
+		parallelFor(level.mNumNodes, [&](std::size_t u) {
+			auto force = tree.repulsion(positions[u], level.mMasses[u], static_cast<int>(u), strength, params.mTheta) / level.mMasses[u];
+			for (auto k = level.mOffsets[u]; k < level.mOffsets[u + 1]; ++k)
+			{
+				auto direction = positions[level.mNeighbors[k]] - positions[u];
+				force += level.mWeights[k] / meanWeight * (direction - direction.getNormalized() * level.mLengths[k]);
+			}
+			forces[u] = force;
+		});
+
+		auto step = restLength * (1.0f - static_cast<float>(iteration) / numIterations);
+		parallelFor(level.mNumNodes, [&](std::size_t u) {
+			auto length = forces[u].length();
+			if (length > 0)
+			{
+				positions[u] += forces[u] * (std::min(length, step) / length);
+			}
+		});
+	}
+}
+
+// FM^3-style multilevel layout: coarsen until the graph has at most mCoarsestSize nodes (or stops
+// shrinking), place the coarsest level at random, then relax it and prolong positions level by level,
+// each child starting next to its parent. The coarsest level gets mIterations, and every finer level
+// half as many as the one above it, down to mMinIterations.
+inline std::vector<ofVec3f> multilevelLayout(int numNodes, const std::vector<Edge> &edges, const MultilevelParams &params, std::mt19937 &engine)
+{
+	std::vector<LayoutLevel> levels(1);
+	levels[0].assign(numNodes, edges);
+	levels[0].mMasses.assign(numNodes, 1.0f);
+	while (levels.back().mNumNodes > params.mCoarsestSize)
+	{
+		auto coarse = coarsen(levels.back(), engine);
+		if (coarse.mNumNodes > 0.9 * levels.back().mNumNodes)
+		{
+			levels.back().mParents.clear();
+			break;
+		}
+		levels.push_back(std::move(coarse));
+	}
+
+	auto restLength = 0.0f;
+	auto meanWeight = 0.0f;
+	for (const auto &edge : edges)
+	{
+		restLength += edge.mLength;
+		meanWeight += edge.mWeight;
+	}
+	restLength = edges.empty() ? 1.0f : restLength / edges.size();
+	meanWeight = edges.empty() || meanWeight <= 0 ? 1.0f : meanWeight / edges.size();
+	auto meanDegree = numNodes > 0 ? std::max(2.0f * edges.size() / numNodes, 1.0f) : 1.0f;
+	auto numIterations = params.mIterations;
+
+	auto uniform = std::uniform_real_distribution<float>(-1.0f, 1.0f);
+	auto jitter = [&] { return ofVec3f(uniform(engine), uniform(engine), uniform(engine)); };
+
+	const auto &coarsest = levels.back();
+	std::vector<ofVec3f> positions(coarsest.mNumNodes);
+	for (auto &position : positions)
+	{
+		position = jitter() * restLength * std::cbrt(static_cast<float>(coarsest.mNumNodes));
+	}
+	relaxLevel(coarsest, positions, params, numIterations, restLength, meanWeight, meanDegree, numNodes);
+
+	for (auto i = static_cast<int>(levels.size()) - 2; i >= 0; --i)
+	{
+		const auto &level = levels[i];
+		std::vector<ofVec3f> fine(level.mNumNodes);
+		for (auto u = 0; u < level.mNumNodes; ++u)
+		{
+			fine[u] = positions[level.mParents[u]] + jitter() * (0.1f * restLength);
+		}
+		positions.swap(fine);
+		numIterations = std::max(numIterations / 2, params.mMinIterations);
+		relaxLevel(level, positions, params, numIterations, restLength, meanWeight, meanDegree, numNodes);
+	}
+	return positions;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Batch node placement. Positions come from a counter-based generator (Philox4x32-10), so node i's
+// position depends only on the key and i: blocks can be filled in any order, by any number of threads,
+// with identical results. Every kernel loop runs over a fixed block of lanes with no branches, so the
+// compiler vectorises the Philox rounds, the Box-Muller normal and the polynomial sincos.
+
+enum class NodePlacement
+{
+	// theta and phi uniform in [-pi, pi), as generateNode has always drawn them; denser at the poles.
+	Angles,
+	// z uniform in [-1, 1) and phi uniform, which is uniform on the sphere (Archimedes).
+	UniformSphere
+};
+
+struct NodePositions
+{
+	std::vector<float> mX;
+	std::vector<float> mY;
+	std::vector<float> mZ;
+};
+
+namespace placement
+{
+	constexpr int kBlockSize = 64;
+	constexpr float kTwoPi = 6.28318530717958647692f;
+
+	// Uniform float in (0, 1] from the top 24 bits, so the logarithm below is always finite.
+	inline float uniform(std::uint32_t bits)
+	{
+		return static_cast<float>((bits >> 8) + 1) * (1.0f / 16777216.0f);
+	}
+
+	// The helpers below stay free of floating-point comparisons and library calls: under the default
+	// -ftrapping-math and -fmath-errno either one keeps GCC from vectorising the loops that use them.
+
+	// Natural logarithm for normal positive floats: split off the exponent with integer operations,
+	// then log(m) = 2 atanh((m - 1) / (m + 1)) as an odd series on m in [sqrt(1/2), sqrt(2)). Relative
+	// error is about 2e-7.
+	inline float log(float x)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		auto mantissaBits = (bits & 0x007fffffu) | 0x3f800000u;
+		auto high = static_cast<std::uint32_t>(mantissaBits > 0x3fb504f3u);
+		mantissaBits -= high << 23;
+		auto exponent = static_cast<int>(bits >> 23) - 127 + static_cast<int>(high);
+		float mantissa;
+		std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+		auto s = (mantissa - 1.0f) / (mantissa + 1.0f);
+		auto s2 = s * s;
+		auto series = s * (2.0f + s2 * (2.0f / 3.0f + s2 * (2.0f / 5.0f + s2 * (2.0f / 7.0f + s2 * (2.0f / 9.0f)))));
+		return series + static_cast<float>(exponent) * 0.69314718056f;
+	}
+
+	// Square root of a non-negative float (-0 included): an exponent-halving bit estimate refined by three Newton
+	// steps, which takes its 4% error to float precision.
+	inline float sqrt(float x)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		bits = ((bits & 0x7fffffffu) >> 1) + 0x1fbb4000u;
+		float y;
+		std::memcpy(&y, &bits, sizeof(y));
+		y = 0.5f * (y + x / y);
+		y = 0.5f * (y + x / y);
+		return 0.5f * (y + x / y);
+	}
+
+	// sin and cos of 2 pi t for t in [-1/2, 1/2] through the half angle a = pi t in [-pi/2, pi/2], where
+	// Taylor polynomials of degree 11 and 12 are accurate to about 1e-7; no range folding is needed.
+	inline void sinCosTurns(float t, float &sine, float &cosine)
+	{
+		auto a = t * (kTwoPi / 2);
+		auto a2 = a * a;
+		auto s = a * (1.0f + a2 * (-1.0f / 6 + a2 * (1.0f / 120 + a2 * (-1.0f / 5040 + a2 * (1.0f / 362880 + a2 * (-1.0f / 39916800))))));
+		auto c = 1.0f + a2 * (-0.5f + a2 * (1.0f / 24 + a2 * (-1.0f / 720 + a2 * (1.0f / 40320 + a2 * (-1.0f / 3628800 + a2 * (1.0f / 479001600))))));
+		sine = 2.0f * s * c;
+		cosine = (c - s) * (c + s);
+	}
+
+	inline std::uint64_t key(std::mt19937 &engine)
+	{
+		return static_cast<std::uint64_t>(engine()) << 32 | engine();
+	}
+
+	// Philox4x32-10 (Salmon et al. 2011) over one block of counters, lanes innermost.
+	inline void philox(std::uint64_t key, std::uint64_t first, std::uint32_t (&out)[4][kBlockSize])
+	{
+		for (auto lane = 0; lane < kBlockSize; ++lane)
+		{
+			auto counter = first + lane;
+			out[0][lane] = static_cast<std::uint32_t>(counter);
+			out[1][lane] = static_cast<std::uint32_t>(counter >> 32);
+			out[2][lane] = 0;
+			out[3][lane] = 0;
+		}
+		auto key0 = static_cast<std::uint32_t>(key);
+		auto key1 = static_cast<std::uint32_t>(key >> 32);
+		for (auto round = 0; round < 10; ++round)
+		{
+			for (auto lane = 0; lane < kBlockSize; ++lane)
+			{
+				auto product0 = static_cast<std::uint64_t>(0xD2511F53u) * out[0][lane];
+				auto product1 = static_cast<std::uint64_t>(0xCD9E8D57u) * out[2][lane];
+				auto c1 = out[1][lane];
+				auto c3 = out[3][lane];
+				out[0][lane] = static_cast<std::uint32_t>(product1 >> 32) ^ c1 ^ key0;
+				out[1][lane] = static_cast<std::uint32_t>(product1);
+				out[2][lane] = static_cast<std::uint32_t>(product0 >> 32) ^ c3 ^ key1;
+				out[3][lane] = static_cast<std::uint32_t>(product0);
+			}
+			key0 += 0x9E3779B9u;
+			key1 += 0xBB67AE85u;
+		}
+	}
+}
+
+// Places nodes first .. first + count - 1 into x, y, z (each of length count). The radius is normal
+// with the given mean and deviation (Box-Muller on the first two Philox words); the last two words
+// give the direction.
+inline void placeNodes(std::uint64_t key, std::size_t first, std::size_t count, float radiusMean, float radiusStd, NodePlacement mode, float *x, float *y, float *z)
+{
+	// Lanes are computed into fixed-size local blocks, which GCC vectorises even at -O2, and copied out.
+	std::uint32_t bits[4][placement::kBlockSize];
+	float radii[placement::kBlockSize];
+	float bx[placement::kBlockSize];
+	float by[placement::kBlockSize];
+	float bz[placement::kBlockSize];
+	for (std::size_t block = 0; block < count; block += placement::kBlockSize)
+	{
+		placement::philox(key, first + block, bits);
+		for (auto lane = 0; lane < placement::kBlockSize; ++lane)
+		{
+			float sine;
+			float cosine;
+			placement::sinCosTurns(placement::uniform(bits[1][lane]) - 0.5f, sine, cosine);
+			radii[lane] = radiusMean + radiusStd * placement::sqrt(-2.0f * placement::log(placement::uniform(bits[0][lane]))) * cosine;
+		}
+
+		if (mode == NodePlacement::UniformSphere)
+		{
+			for (auto lane = 0; lane < placement::kBlockSize; ++lane)
+			{
+				float sinPhi;
+				float cosPhi;
+				placement::sinCosTurns(placement::uniform(bits[3][lane]) - 0.5f, sinPhi, cosPhi);
+				auto height = 2.0f * placement::uniform(bits[2][lane]) - 1.0f;
+				auto ring = placement::sqrt((1.0f - height) * (1.0f + height));
+				bx[lane] = radii[lane] * ring * cosPhi;
+				by[lane] = radii[lane] * ring * sinPhi;
+				bz[lane] = radii[lane] * height;
+			}
+		}
+		else
+		{
+			for (auto lane = 0; lane < placement::kBlockSize; ++lane)
+			{
+				float sinTheta;
+				float cosTheta;
+				float sinPhi;
+				float cosPhi;
+				placement::sinCosTurns(placement::uniform(bits[2][lane]) - 0.5f, sinTheta, cosTheta);
+				placement::sinCosTurns(placement::uniform(bits[3][lane]) - 0.5f, sinPhi, cosPhi);
+				bx[lane] = radii[lane] * sinTheta * cosPhi;
+				by[lane] = radii[lane] * sinTheta * sinPhi;
+				bz[lane] = radii[lane] * cosTheta;
+			}
+		}
+
+		auto lanes = std::min<std::size_t>(placement::kBlockSize, count - block);
+		std::copy(bx, bx + lanes, x + block);
+		std::copy(by, by + lanes, y + block);
+		std::copy(bz, bz + lanes, z + block);
+	}
+}
+
+// Fills SoA positions for numNodes nodes in parallel. One key is drawn from engine per call, so
+// successive calls give different layouts while the result is independent of the thread count.
+inline void placeNodes(std::mt19937 &engine, NodePositions &positions, std::size_t numNodes, float radiusMean, float radiusStd, NodePlacement mode = NodePlacement::Angles, int threads = numThreads())
+{
+	auto key = placement::key(engine);
+	positions.mX.resize(numNodes);
+	positions.mY.resize(numNodes);
+	positions.mZ.resize(numNodes);
+	// Ranges are cut on block boundaries so every thread but the last fills whole blocks.
+	auto numBlocks = (numNodes + placement::kBlockSize - 1) / placement::kBlockSize;
+	parallelRanges(numBlocks, [&](int, std::size_t firstBlock, std::size_t lastBlock) {
+		auto first = firstBlock * placement::kBlockSize;
+		auto last = std::min(lastBlock * placement::kBlockSize, numNodes);
+		placeNodes(key, first, last - first, radiusMean, radiusStd, mode, positions.mX.data() + first, positions.mY.data() + first, positions.mZ.data() + first);
+	}, threads);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Per-thread cap on numThreads(); 0 means no cap. See ScopedThreadLimit.
+inline int &threadLimit()
+{
+	thread_local int limit = 0;
+	return limit;
+}
+
+inline int numThreads()
+{
+	auto threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	return threadLimit() > 0 ? std::min(threadLimit(), threads) : threads;
+}
+
+// Caps the threads that parallel helpers called from this thread start, e.g. to 1 inside workers that
+// already run in parallel, so nested parallelism does not multiply the thread count.
+class ScopedThreadLimit
+{
+public:
+	explicit ScopedThreadLimit(int limit) : mPrevious(threadLimit()) { threadLimit() = limit; }
+	~ScopedThreadLimit() { threadLimit() = mPrevious; }
+
+	ScopedThreadLimit(const ScopedThreadLimit &) = delete;
+	ScopedThreadLimit &operator=(const ScopedThreadLimit &) = delete;
+
+private:
+	int mPrevious;
+};
+
+// Splits [0, count) into one contiguous range per thread and calls function(thread, first, last).
+template <typename Function>
+void parallelRanges(std::size_t count, Function function, int threads = numThreads())
+{
+	threads = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, count)));
+	if (threads == 1)
+	{
+		function(0, std::size_t(0), count);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	for (auto thread = 0; thread < threads; ++thread)
+	{
+		workers.emplace_back(function, thread, count * thread / threads, count * (thread + 1) / threads);
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+template <typename Function>
+void parallelFor(std::size_t count, Function function)
+{
+	parallelRanges(count, [&](int, std::size_t first, std::size_t last) {
+		for (auto i = first; i < last; ++i)
+		{
+			function(i);
+		}
+	});
+}
+
+// Sorts one range per thread, then merges neighbouring ranges pairwise, halving the number of
+// sorted runs each round.
+template <typename Iterator, typename Compare>
+void parallelSort(Iterator first, Iterator last, Compare compare, int threads = numThreads())
+{
+	auto count = static_cast<std::size_t>(last - first);
+	threads = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, count / 4096)));
+	std::vector<std::size_t> bounds(threads + 1);
+	for (auto thread = 0; thread <= threads; ++thread)
+	{
+		bounds[thread] = count * thread / threads;
+	}
+	parallelRanges(threads, [&](int, std::size_t firstRun, std::size_t lastRun) {
+		for (auto run = firstRun; run < lastRun; ++run)
+		{
+			std::sort(first + bounds[run], first + bounds[run + 1], compare);
+		}
+	}, threads);
+	for (auto width = 1; width < threads; width *= 2)
+	{
+		auto pairs = (threads + 2 * width - 1) / (2 * width);
+		parallelRanges(pairs, [&](int, std::size_t firstPair, std::size_t lastPair) {
+			for (auto pair = firstPair; pair < lastPair; ++pair)
+			{
+				auto low = pair * 2 * width;
+				auto middle = std::min<std::size_t>(low + width, threads);
+				auto high = std::min<std::size_t>(low + 2 * width, threads);
+				std::inplace_merge(first + bounds[low], first + bounds[middle], first + bounds[high], compare);
+			}
+		}, pairs);
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+// Per-stage frame profiler. Everything here, including the PROFILE_SCOPE timers, only exists when
+// RANDOM_GRAPH_PROFILE is defined; otherwise the macro expands to nothing.
+
+#ifdef RANDOM_GRAPH_PROFILE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Profiler
+{
+	struct Stage
+	{
+		std::string mName;
+		std::vector<float> mSamples;
+		std::size_t mNext = 0;
+	};
+
+	struct Event
+	{
+		int mStage;
+		std::int64_t mStart;
+		std::int64_t mDuration;
+	};
+
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit Profiler(std::size_t historySize = 256, std::size_t traceSize = 1 << 16) : mHistorySize(historySize), mTraceSize(traceSize), mEpoch(Clock::now()) {}
+
+	void record(const char *name, Clock::time_point start, Clock::time_point end)
+	{
+		auto found = mIndices.find(name);
+		if (found == mIndices.end())
+		{
+			found = mIndices.emplace(name, static_cast<int>(mStages.size())).first;
+			mStages.push_back(Stage{name});
+		}
+
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		auto &stage = mStages[found->second];
+		if (stage.mSamples.size() < mHistorySize)
+		{
+			stage.mSamples.push_back(duration / 1000.0f);
+		}
+		else
+		{
+			stage.mSamples[stage.mNext] = duration / 1000.0f;
+		}
+		stage.mNext = (stage.mNext + 1) % mHistorySize;
+
+		auto event = Event{found->second, std::chrono::duration_cast<std::chrono::microseconds>(start - mEpoch).count(), duration};
+		if (mEvents.size() < mTraceSize)
+		{
+			mEvents.push_back(event);
+		}
+		else
+		{
+			mEvents[mNextEvent] = event;
+		}
+		mNextEvent = (mNextEvent + 1) % mTraceSize;
+	}
+
+	std::size_t numStages() const { return mStages.size(); }
+	const std::string &stageName(std::size_t stage) const { return mStages[stage].mName; }
+
+	// Percentile of the rolling window in milliseconds, q in [0, 1].
+	float percentile(std::size_t stage, float q) const
+	{
+		auto samples = mStages[stage].mSamples;
+		if (samples.empty())
+		{
+			return 0.0f;
+		}
+		auto nth = samples.begin() + static_cast<std::size_t>(q * (samples.size() - 1) + 0.5f);
+		std::nth_element(samples.begin(), nth, samples.end());
+		return *nth;
+	}
+
+	// Chrome trace-event JSON with complete ("X") events, loadable in Perfetto or chrome://tracing.
+	void exportTrace(const std::string &path) const
+	{
+		auto file = std::fopen(path.c_str(), "w");
+		if (!file)
+		{
+			throw std::runtime_error("cannot open " + path);
+		}
+		std::fprintf(file, "{\"traceEvents\":[");
+		auto first = mEvents.size() < mTraceSize ? 0 : mNextEvent;
+		for (std::size_t i = 0; i < mEvents.size(); ++i)
+		{
+			const auto &event = mEvents[(first + i) % mEvents.size()];
+			std::fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%lld,\"dur\":%lld}", i == 0 ? "" : ",",
+						 mStages[event.mStage].mName.c_str(), static_cast<long long>(event.mStart), static_cast<long long>(event.mDuration));
+		}
+		std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+		if (std::fclose(file) != 0)
+		{
+			throw std::runtime_error("failed to write " + path);
+		}
+	}
+
+private:
+	std::size_t mHistorySize;
+	std::size_t mTraceSize;
+	Clock::time_point mEpoch;
+	std::unordered_map<std::string, int> mIndices;
+	std::vector<Stage> mStages;
+	std::vector<Event> mEvents;
+	std::size_t mNextEvent = 0;
+};
+
+class ProfileScope
+{
+public:
+	ProfileScope(Profiler &profiler, const char *name) : mProfiler(profiler), mName(name), mStart(Profiler::Clock::now()) {}
+
+	~ProfileScope()
+	{
+		mProfiler.record(mName, mStart, Profiler::Clock::now());
+	}
+
+private:
+	Profiler &mProfiler;
+	const char *mName;
+	Profiler::Clock::time_point mStart;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(profiler, name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(profiler, name)
+
+#else
+
+#define PROFILE_SCOPE(profiler, name)
+
+#endif
@@ -1,6 +1,22 @@
 #pragma once
 
 #include "ofMain.h"
+#include "dirty_ranges.hpp"
+#include "force_atlas2.hpp"
+#include "dynamic_graph.hpp"
+#include "graph.hpp"
+#include "graph_export.hpp"
+#include "graph_file.hpp"
+#include "graph_generator.hpp"
+#include "graph_growth.hpp"
+#include "graph_import.hpp"
+#include "graph_stats.hpp"
+#include "multilevel_layout.hpp"
+#include "profiler.hpp"
+#include "spectral_layout.hpp"
+#include "stress_layout.hpp"
+#include "union_find.hpp"
+#include "verlet_list.hpp"
 #include <random>
 
 class RandomGraph : public ofBaseApp
@@ -9,40 +25,86 @@ class RandomGraph : public ofBaseApp
 	{
 		ErdosRenyi,
 		BarabasiAlbert,
-		WattsStrogatz
+		WattsStrogatz,
+		Rmat,
+		StochasticBlockModel,
+		ChungLu,
+		ConfigurationModel,
+		RandomGeometric,
+		Loaded
 	};
 
-	struct Node
+	enum class ForceModel
 	{
-		ofVec3f mPosition;
-		ofVec3f mVelocity;
-		ofVec3f mAcceleration;
-	};
-
-	struct Edge
-	{
-		int mHead;
-		int mTail;
-		float mLength;
-		float mWeight;
+		Springs,
+		ForceAtlas2
 	};
 
 public:
+	bool setupGraph();
 	void setup() override;
 	void update() override;
+	void growGraph();
+	void updateNoise();
+	void updateSprings();
+	void updateCollisions();
+	void updateNodes();
+	void updateForceAtlas2();
+	void updateVertices(const ofRectangle &);
+	void invalidateVertices();
 	void draw() override;
+	void drawLabels();
+	void drawNodes();
+	void drawEdges();
+	void drawVertices();
 	void keyPressed(int) override;
 
 	Node generateNode(float, float);
+	GeneratorParams generatorParams(float, float);
 	void generateErdosRenyi(int, float, float, float);
 	void generateBarabasiAlbert(int, float, float, int);
 	void generateWattsStrogatz(int, float, float, int, float);
+	void generateRmat(int, float, float, const RmatParams &);
+	void generateStochasticBlockModel(int, float, float, const SbmParams &);
+	void generateChungLu(const std::vector<int> &, float, float);
+	void generateConfigurationModel(const std::vector<int> &, float, float, bool);
+	void generateRandomGeometric(int, float, float, const GeometricParams &);
+	std::vector<int> targetDegrees();
+	void saveGraph(const std::string &);
+	bool loadGraph(const std::string &);
+	void exportGraph(const std::string &);
+	void graphChanged();
+	void graphChanged(const CsrGraph &);
+	void analyzeGraph();
+	void analyzeGraph(const CsrGraph &);
+	void setGrowing(bool);
+	void spectralLayout();
+	void multilevelLayout();
+	void stressLayout();
 
 	std::vector<Node> mNodes;
 	std::vector<Edge> mEdges;
+	DynamicGraph mGraph;
 	std::vector<ofVec2f> mVertices;
+	std::vector<ofVec3f> mProjectedPositions;
+	DirtyRanges mDirtyVertices;
+	bool mVerticesValid = false;
+	ofRectangle mProjectedViewport;
+	ofVec3f mProjectedCameraPosition;
+	ofVec3f mProjectedCameraLook;
+	ofVec3f mProjectedCameraUp;
+	GraphStats mStats;
+	Components mComponents;
+	bool mColorByComponent = false;
+	bool mCollisions = false;
+	VerletList mCollisionPairs;
 
-	GraphType mGraphType;
+	GraphType mGraphType = GraphType::WattsStrogatz;
+	ForceModel mForceModel = ForceModel::Springs;
+	ForceAtlas2 mForceAtlas2;
+	std::string mGraphPath = "graph.rgraph";
+	std::string mDegreePath = "degrees.txt";
+	std::string mDegreeSource;
 	std::unordered_map<std::string, float> mParams;
 
 	ofTrueTypeFont mLargeFont;
@@ -54,12 +116,29 @@ public:
 	int mNumEdges;
 	int mNumNeighbors;
 	float mRewireProb;
+	RmatParams mRmatParams;
+	int mNumBlocks;
+	float mInProb;
+	float mOutProb;
+	GeometricParams mGeometricParams;
+	GraphGrowth mGrowth;
+	GrowthParams mGrowthParams;
+	bool mGrowing = false;
 
 	std::random_device mSeed;
 	std::mt19937 mEngine;
+
+#ifdef RANDOM_GRAPH_PROFILE
+	void drawProfile();
+
+	Profiler mProfiler;
+#endif
 };
 
-void RandomGraph::setup()
+// Parameters and the initial graph only; safe to call without a window for headless export. Returns
+// false when the graph file exists but cannot be loaded; the default Watts-Strogatz graph is generated
+// in its place, so the viewer always has a graph and a graph type to draw.
+inline bool RandomGraph::setupGraph()
 {
 	mParams = {{"largeFontSize", 20},
 			   {"smallFontSize", 10},
@@ -68,6 +147,7 @@ void RandomGraph::setup()
 			   {"numNodes", 100},
 			   {"radiusMean", 100.0},
 			   {"radiusStd", 10.0},
+			   {"uniformSphere", 0},
 			   {"edgeProbMin", 0.05},
 			   {"edgeProbMax", 0.2},
 			   {"numEdgesMin", 1},
@@ -76,10 +156,50 @@ void RandomGraph::setup()
 			   {"numNeighborsMax", 20},
 			   {"rewireProbMin", 0.01},
 			   {"rewireProbMax", 0.1},
+			   {"wattsStrogatzRing", 0},
+			   {"rmatA", 0.57},
+			   {"rmatB", 0.19},
+			   {"rmatC", 0.19},
+			   {"rmatEdgeFactor", 16},
+			   {"rmatPermute", 1},
+			   {"rmatDedupe", 1},
+			   {"sbmBlocksMin", 3},
+			   {"sbmBlocksMax", 6},
+			   {"sbmInProbMin", 0.2},
+			   {"sbmInProbMax", 0.4},
+			   {"sbmOutProb", 0.01},
+			   {"sbmSpread", 0.25},
+			   {"configErase", 1},
+			   {"geometricRadiusMin", 30},
+			   {"geometricRadiusMax", 50},
+			   {"geometricPeriodic", 0},
+			   {"growthNodesPerStep", 1},
+			   {"growthEdgesPerNode", 2},
+			   {"growthMaxNodes", 2000},
+			   {"growthRewiresPerStep", 0},
+			   {"growthChurnPerStep", 0},
+			   {"growthSpawnRadius", 10},
 			   {"edgeWeightMin", 0.0},
 			   {"edgeWeightMax", 0.1},
+			   {"edgeChunkSize", 65536},
+			   {"pathLengthSamples", 64},
+			   {"spectralInit", 0},
+			   {"spectralIterations", 200},
+			   {"multilevelIterations", 100},
+			   {"multilevelRepulsion", 1.0},
+			   {"stressPivots", 50},
+			   {"stressIterations", 100},
+			   {"fa2Scaling", 2.0},
+			   {"fa2Gravity", 1.0},
+			   {"fa2LinLog", 0},
+			   {"fa2Theta", 1.2},
+			   {"fa2Tolerance", 1.0},
+			   {"collisionRadius", 0.2},
+			   {"collisionStiffness", 10.0},
+			   {"collisionSkin", 0.2},
 			   {"perlinNoiseNorm", 10.0},
 			   {"deltaTime", 0.1},
+			   {"vertexSleepDistance", 0.01},
 			   {"cameraPositionX", 1000.0},
 			   {"cameraPositionY", 1000.0},
 			   {"cameraPositionZ", 1000.0},
@@ -87,10 +207,26 @@ void RandomGraph::setup()
 			   {"cameraTargetY", 0.0},
 			   {"cameraTargetZ", 0.0}};
 
+	auto loaded = true;
+	if (ofFile::doesFileExist(mGraphPath))
+	{
+		if (loadGraph(mGraphPath))
+		{
+			return true;
+		}
+		ofLogError("RandomGraph") << "cannot load " << mGraphPath << "; generating a Watts-Strogatz graph instead";
+		loaded = false;
+	}
 	mGraphType = GraphType::WattsStrogatz;
 	mNumNeighbors = std::uniform_int_distribution<int>(mParams["numNeighborsMin"], mParams["numNeighborsMax"])(mEngine);
-	mRewireProb = std::uniform_real_distribution<float>(mParams["rewireProbsMin"], mParams["rewireProbMax"])(mEngine);
+	mRewireProb = std::uniform_real_distribution<float>(mParams["rewireProbMin"], mParams["rewireProbMax"])(mEngine);
 	generateWattsStrogatz(mParams["numNodes"], mParams["radiusMean"], mParams["radiusStd"], mNumNeighbors, mRewireProb);
+	return loaded;
+}
+
+inline void RandomGraph::setup()
+{
+	setupGraph();
 
 	ofBackground(240);
 	ofEnableDepthTest();
@@ -99,13 +235,59 @@ void RandomGraph::setup()
 	mLargeFont.load("Helvetica", mParams["largeFontSize"]);
 	mSmallFont.load("Helvetica", mParams["smallFontSize"]);
 	mShader.load("", "shader.flag");
+	invalidateVertices();
 	mCamera.setAutoDistance(false);
 	mCamera.setPosition(ofPoint(mParams["cameraPositionX"], mParams["cameraPositionY"], mParams["cameraPositionZ"]));
 	mCamera.setTarget(ofPoint(mParams["cameraTargetX"], mParams["cameraTargetY"], mParams["cameraTargetZ"]));
 }
 
-void RandomGraph::update()
+inline void RandomGraph::update()
+{
+	PROFILE_SCOPE(mProfiler, "update");
+	if (mGrowing)
+	{
+		growGraph();
+	}
+	if (mForceModel == ForceModel::ForceAtlas2)
+	{
+		updateForceAtlas2();
+	}
+	else
+	{
+		updateNoise();
+		updateSprings();
+		if (mCollisions)
+		{
+			updateCollisions();
+		}
+		updateNodes();
+	}
+	updateVertices(ofGetCurrentViewport());
+}
+
+// One step of growth, rewiring and churn. Only the two degree statistics are kept current, from the
+// growth index, and the component labels while they colour the nodes (churn and rewiring remove
+// edges, so the labels are recomputed rather than extended); the full analysis waits until growth is
+// switched off.
+inline void RandomGraph::growGraph()
 {
+	PROFILE_SCOPE(mProfiler, "grow");
+	auto delta = mGrowth.step(mNodes, mGraph, mGrowthParams, generatorParams(mParams["radiusMean"], mParams["radiusStd"]));
+	if (delta.empty())
+	{
+		return;
+	}
+	mStats.mMeanDegree = mNodes.empty() ? 0.0 : 2.0 * mEdges.size() / mNodes.size();
+	mStats.mMaxDegree = mGrowth.maxDegree();
+	if (mColorByComponent)
+	{
+		mComponents = connectedComponents(mNodes.size(), mEdges);
+	}
+}
+
+inline void RandomGraph::updateNoise()
+{
+	PROFILE_SCOPE(mProfiler, "noise");
 	for (auto &node : mNodes)
 	{
 		node.mAcceleration = ofVec3f(ofSignedNoise(node.mPosition.x, node.mPosition.y, node.mPosition.z),
@@ -113,7 +295,11 @@ void RandomGraph::update()
 									 ofSignedNoise(node.mPosition.z, node.mPosition.x, node.mPosition.y)) *
 							 mParams["perlinNoiseNorm"];
 	}
+}
 
+inline void RandomGraph::updateSprings()
+{
+	PROFILE_SCOPE(mProfiler, "springs");
 	for (const auto &edge : mEdges)
 	{
 		auto direction = mNodes[edge.mTail].mPosition - mNodes[edge.mHead].mPosition;
@@ -121,23 +307,126 @@ void RandomGraph::update()
 		mNodes[edge.mHead].mAcceleration += edge.mWeight * stretch;
 		mNodes[edge.mTail].mAcceleration -= edge.mWeight * stretch;
 	}
+}
+
+// Penalty springs between nodes closer than collisionRadius (two node radii by default). Candidates come
+// from a Verlet list with collisionSkin of slack, rebuilt through the hash grid only once some node has
+// moved half the skin, so most frames are one pass over the nearby pairs.
+inline void RandomGraph::updateCollisions()
+{
+	PROFILE_SCOPE(mProfiler, "collisions");
+	auto radius = mParams["collisionRadius"];
+	auto stiffness = mParams["collisionStiffness"];
+	if (radius <= 0)
+	{
+		return;
+	}
+	mCollisionPairs.update(mNodes.size(), radius, std::max(mParams["collisionSkin"], 0.0f), [&](std::size_t i) { return mNodes[i].mPosition; });
+	parallelFor(mNodes.size(), [&](std::size_t i) {
+		auto &node = mNodes[i];
+		for (auto k = mCollisionPairs.begin(i); k != mCollisionPairs.end(i); ++k)
+		{
+			auto j = mCollisionPairs.neighbor(k);
+			auto direction = node.mPosition - mNodes[j].mPosition;
+			auto distance = direction.length();
+			if (distance < radius)
+			{
+				// Coincident nodes separate along an index-dependent axis.
+				auto normal = distance > 0 ? direction / distance : ofVec3f(i < static_cast<std::size_t>(j) ? 1.0f : -1.0f, 0, 0);
+				node.mAcceleration += normal * (stiffness * (radius - distance));
+			}
+		}
+	});
+}
 
+inline void RandomGraph::updateNodes()
+{
+	PROFILE_SCOPE(mProfiler, "integrate");
 	for (auto &node : mNodes)
 	{
 		node.mVelocity += node.mAcceleration * mParams["deltaTime"];
 		node.mPosition += node.mVelocity * mParams["deltaTime"] + 0.5 * node.mAcceleration * mParams["deltaTime"] * mParams["deltaTime"];
 	}
+}
+
+inline void RandomGraph::updateForceAtlas2()
+{
+	PROFILE_SCOPE(mProfiler, "forceatlas2");
+	if (mForceAtlas2.numNodes() != mNodes.size())
+	{
+		mForceAtlas2.resize(mNodes.size());
+	}
+	ForceAtlas2Params params;
+	params.mScaling = mParams["fa2Scaling"];
+	params.mGravity = mParams["fa2Gravity"];
+	params.mLinLog = mParams["fa2LinLog"] != 0;
+	params.mTheta = mParams["fa2Theta"];
+	params.mJitterTolerance = mParams["fa2Tolerance"];
+	mForceAtlas2.step(mNodes, mGraph, params);
+}
+
+// Reprojects only nodes that moved more than vertexSleepDistance since their last projection, and
+// marks them dirty for drawVertices. A moved camera or a resized viewport shifts every vertex.
+inline void RandomGraph::updateVertices(const ofRectangle &viewport)
+{
+	PROFILE_SCOPE(mProfiler, "project");
+	ofVec3f cameraPosition = mCamera.getPosition();
+	ofVec3f cameraLook = mCamera.getLookAtDir();
+	ofVec3f cameraUp = mCamera.getUpDir();
+	if (viewport != mProjectedViewport || cameraPosition != mProjectedCameraPosition || cameraLook != mProjectedCameraLook || cameraUp != mProjectedCameraUp)
+	{
+		mProjectedViewport = viewport;
+		mProjectedCameraPosition = cameraPosition;
+		mProjectedCameraLook = cameraLook;
+		mProjectedCameraUp = cameraUp;
+		mVerticesValid = false;
+	}
 
-	mVertices.clear();
-	for (const auto &node : mNodes)
+	auto numValid = mVerticesValid ? std::min(mVertices.size(), mNodes.size()) : 0;
+	auto sleepDistance = mParams["vertexSleepDistance"];
+	mVertices.resize(mNodes.size());
+	mProjectedPositions.resize(mNodes.size());
+	for (std::size_t i = 0; i < mNodes.size(); ++i)
 	{
-		auto position = mCamera.worldToScreen(node.mPosition);
-		mVertices.emplace_back(position.x, ofMap(position.y, 0, ofGetHeight(), ofGetHeight(), 0));
+		const auto &node = mNodes[i];
+		if (i < numValid && node.mPosition.squareDistance(mProjectedPositions[i]) <= sleepDistance * sleepDistance)
+		{
+			continue;
+		}
+		auto position = mCamera.worldToScreen(node.mPosition, viewport);
+		mVertices[i] = ofVec2f(position.x, ofMap(position.y, 0, viewport.height, viewport.height, 0));
+		mProjectedPositions[i] = node.mPosition;
+		mDirtyVertices.mark(i);
 	}
+	mVerticesValid = true;
 }
 
-void RandomGraph::draw()
+// Forces a full reprojection and upload on the next frame.
+inline void RandomGraph::invalidateVertices()
 {
+	mVerticesValid = false;
+}
+
+inline void RandomGraph::draw()
+{
+	PROFILE_SCOPE(mProfiler, "draw");
+	drawLabels();
+
+	mCamera.begin();
+	drawNodes();
+	drawEdges();
+	mCamera.end();
+
+	drawVertices();
+
+#ifdef RANDOM_GRAPH_PROFILE
+	drawProfile();
+#endif
+}
+
+inline void RandomGraph::drawLabels()
+{
+	PROFILE_SCOPE(mProfiler, "labels");
 	ofSetColor(0);
 	switch (mGraphType)
 	{
@@ -154,122 +443,504 @@ void RandomGraph::draw()
 		mSmallFont.drawString("Num Neighbors: " + std::to_string(mNumNeighbors), ofGetWidth() - 200, 100);
 		mSmallFont.drawString("Rewire Prob: " + std::to_string(mRewireProb), ofGetWidth() - 200, 120);
 		break;
+	case GraphType::Rmat:
+		mLargeFont.drawString("R-MAT", 100, 100);
+		mSmallFont.drawString("Edge Factor: " + std::to_string(mRmatParams.mEdgeFactor), ofGetWidth() - 200, 100);
+		mSmallFont.drawString("a, b, c: " + ofToString(mRmatParams.mA, 2) + ", " + ofToString(mRmatParams.mB, 2) + ", " + ofToString(mRmatParams.mC, 2), ofGetWidth() - 200, 120);
+		break;
+	case GraphType::StochasticBlockModel:
+		mLargeFont.drawString("Stochastic Block Model", 100, 100);
+		mSmallFont.drawString("Num Blocks: " + std::to_string(mNumBlocks), ofGetWidth() - 200, 100);
+		mSmallFont.drawString("In/Out Prob: " + ofToString(mInProb, 3) + " / " + ofToString(mOutProb, 3), ofGetWidth() - 200, 120);
+		break;
+	case GraphType::ChungLu:
+		mLargeFont.drawString("Chung Lu", 100, 100);
+		mSmallFont.drawString("Degrees: " + mDegreeSource, ofGetWidth() - 200, 100);
+		break;
+	case GraphType::ConfigurationModel:
+		mLargeFont.drawString("Configuration Model", 100, 100);
+		mSmallFont.drawString("Degrees: " + mDegreeSource, ofGetWidth() - 200, 100);
+		mSmallFont.drawString(mParams["configErase"] ? "Loops/Multi-edges: Erased" : "Loops/Multi-edges: Kept", ofGetWidth() - 200, 120);
+		break;
+	case GraphType::RandomGeometric:
+		mLargeFont.drawString("Random Geometric", 100, 100);
+		mSmallFont.drawString("Radius: " + std::to_string(mGeometricParams.mRadius), ofGetWidth() - 200, 100);
+		mSmallFont.drawString(mGeometricParams.mPeriodic ? "Boundaries: Periodic" : "Boundaries: Open", ofGetWidth() - 200, 120);
+		break;
+	case GraphType::Loaded:
+		mLargeFont.drawString("Loaded Graph", 100, 100);
+		mSmallFont.drawString("File: " + mGraphPath, ofGetWidth() - 200, 100);
+		break;
 	}
+	mSmallFont.drawString("Mean Degree: " + std::to_string(mStats.mMeanDegree), ofGetWidth() - 200, 160);
+	mSmallFont.drawString("Max Degree: " + std::to_string(mStats.mMaxDegree), ofGetWidth() - 200, 180);
+	mSmallFont.drawString("Clustering: " + std::to_string(mStats.mGlobalClustering), ofGetWidth() - 200, 200);
+	mSmallFont.drawString("Avg Clustering: " + std::to_string(mStats.mAverageClustering), ofGetWidth() - 200, 220);
+	mSmallFont.drawString("Path Length: " + std::to_string(mStats.mAveragePathLength), ofGetWidth() - 200, 240);
+	mSmallFont.drawString("Diameter: >= " + std::to_string(mStats.mDiameter), ofGetWidth() - 200, 260);
+	mSmallFont.drawString("Components: " + std::to_string(mComponents.mNumComponents), ofGetWidth() - 200, 280);
+	mSmallFont.drawString("Giant Component: " + std::to_string(mComponents.mGiantSize), ofGetWidth() - 200, 300);
+	mSmallFont.drawString(mForceModel == ForceModel::ForceAtlas2 ? "Forces: ForceAtlas2" : "Forces: Springs", ofGetWidth() - 200, 340);
+	if (mGrowing)
+	{
+		mSmallFont.drawString("Growing: " + std::to_string(mNodes.size()) + " nodes", ofGetWidth() - 200, 360);
+	}
+	mSmallFont.drawString("a: Grow Graph", ofGetWidth() - 200, ofGetHeight() - 380);
+	mSmallFont.drawString("g: Random Geometric", ofGetWidth() - 200, ofGetHeight() - 360);
+	mSmallFont.drawString("n: Configuration Model", ofGetWidth() - 200, ofGetHeight() - 340);
+	mSmallFont.drawString("u: Chung Lu", ofGetWidth() - 200, ofGetHeight() - 320);
+	mSmallFont.drawString("s: Stochastic Block Model", ofGetWidth() - 200, ofGetHeight() - 300);
+	mSmallFont.drawString("r: R-MAT", ofGetWidth() - 200, ofGetHeight() - 280);
+	mSmallFont.drawString("o: Collisions", ofGetWidth() - 200, ofGetHeight() - 260);
+	mSmallFont.drawString("d: Stress Layout", ofGetWidth() - 200, ofGetHeight() - 240);
+	mSmallFont.drawString("f: Force Model", ofGetWidth() - 200, ofGetHeight() - 220);
+	mSmallFont.drawString("m: Multilevel Layout", ofGetWidth() - 200, ofGetHeight() - 200);
+	mSmallFont.drawString("i: Spectral Layout", ofGetWidth() - 200, ofGetHeight() - 180);
+	mSmallFont.drawString("p: Color Components", ofGetWidth() - 200, ofGetHeight() - 160);
 	mSmallFont.drawString("e: Erdos Renyi", ofGetWidth() - 200, ofGetHeight() - 140);
 	mSmallFont.drawString("b: Barabasi Albert", ofGetWidth() - 200, ofGetHeight() - 120);
 	mSmallFont.drawString("w: Watts Strogatz", ofGetWidth() - 200, ofGetHeight() - 100);
+	mSmallFont.drawString("S/L: Save/Load Graph", ofGetWidth() - 200, ofGetHeight() - 80);
+	mSmallFont.drawString("x: Export Graph", ofGetWidth() - 200, ofGetHeight() - 60);
+#ifdef RANDOM_GRAPH_PROFILE
+	mSmallFont.drawString("t: Export Trace", ofGetWidth() - 200, ofGetHeight() - 40);
+#endif
+}
 
-	mCamera.begin();
+inline void RandomGraph::drawNodes()
+{
+	PROFILE_SCOPE(mProfiler, "nodes");
 	ofSetColor(0);
-	for (const auto &node : mNodes)
+	for (std::size_t i = 0; i < mNodes.size(); ++i)
 	{
-		ofDrawSphere(node.mPosition, mParams["nodeRadius"]);
+		// The giant component stays black; the others get a hue from their label.
+		if (mColorByComponent && i < mComponents.mLabels.size())
+		{
+			auto label = mComponents.mLabels[i];
+			ofSetColor(label == mComponents.mGiantLabel ? ofColor(0) : ofColor::fromHsb(label * 47 % 256, 200, 220));
+		}
+		ofDrawSphere(mNodes[i].mPosition, mParams["nodeRadius"]);
 	}
+}
+
+inline void RandomGraph::drawEdges()
+{
+	PROFILE_SCOPE(mProfiler, "edges");
 	for (const auto &edge : mEdges)
 	{
 		ofSetColor(0, 0, 0, 255 * (1 - edge.mWeight / mParams["edgeWeightMax"]));
 		ofDrawLine(mNodes[edge.mHead].mPosition, mNodes[edge.mTail].mPosition);
 	}
-	mCamera.end();
+}
 
+inline void RandomGraph::drawVertices()
+{
+	PROFILE_SCOPE(mProfiler, "shader");
 	mShader.begin();
-	mShader.setUniform2fv("vertices", &mVertices[0][0], mVertices.size());
+	// Uniforms keep their values between frames, so only dirty ranges are uploaded, each at its first
+	// element; when nothing moved nothing is sent.
+	for (const auto &range : mDirtyVertices.ranges())
+	{
+		mShader.setUniform2fv("vertices[" + std::to_string(range.mFirst) + "]", &mVertices[range.mFirst][0], range.mLast - range.mFirst);
+	}
+	mDirtyVertices.clear();
 	ofSetColor(0);
 	ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
 	mShader.end();
 }
 
-RandomGraph::Node RandomGraph::generateNode(float radiusMean, float radiusStd)
+#ifdef RANDOM_GRAPH_PROFILE
+inline void RandomGraph::drawProfile()
+{
+	ofSetColor(0);
+	for (std::size_t i = 0; i < mProfiler.numStages(); ++i)
+	{
+		auto text = mProfiler.stageName(i) + ": p50 " + ofToString(mProfiler.percentile(i, 0.5f), 3) +
+					" ms, p99 " + ofToString(mProfiler.percentile(i, 0.99f), 3) + " ms";
+		mSmallFont.drawString(text, 100, 140 + 20 * i);
+	}
+}
+#endif
+
+inline Node RandomGraph::generateNode(float radiusMean, float radiusStd)
+{
+	return ::generateNode(mEngine, radiusMean, radiusStd);
+}
+
+// Generator settings resolved from mParams once per graph rather than per edge.
+inline GeneratorParams RandomGraph::generatorParams(float radiusMean, float radiusStd)
+{
+	GeneratorParams params;
+	params.mRadiusMean = radiusMean;
+	params.mRadiusStd = radiusStd;
+	params.mEdgeWeightMin = mParams["edgeWeightMin"];
+	params.mEdgeWeightMax = mParams["edgeWeightMax"];
+	params.mPlacement = mParams["uniformSphere"] ? NodePlacement::UniformSphere : NodePlacement::Angles;
+	return params;
+}
+
+inline void RandomGraph::generateErdosRenyi(int numNodes, float radiusMean, float radiusStd, float edgeProb)
+{
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, numNodes);
+
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	streamErdosRenyi(context, mNodes, edgeProb, stream);
+	graphChanged();
+}
+
+inline void RandomGraph::generateBarabasiAlbert(int numNodes, float radiusMean, float radiusStd, int numEdges)
 {
-	auto radius = std::normal_distribution<float>(radiusMean, radiusStd)(mEngine);
-	auto theta = std::uniform_real_distribution<float>(-M_PI, +M_PI)(mEngine);
-	auto phi = std::uniform_real_distribution<float>(-M_PI, +M_PI)(mEngine);
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, numNodes);
 
-	return Node{ofVec3f(radius * std::sin(theta) * std::cos(phi),
-						radius * std::sin(theta) * std::sin(phi),
-						radius * std::cos(theta))};
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	streamBarabasiAlbert(context, mNodes, numEdges, stream);
+	graphChanged();
 }
 
-void RandomGraph::generateErdosRenyi(int numNodes, float radiusMean, float radiusStd, float edgeProb)
+inline void RandomGraph::generateWattsStrogatz(int numNodes, float radiusMean, float radiusStd, int numNeighbors, float rewireProb)
 {
-	mNodes.clear();
-	for (auto i = 0; i < numNodes; ++i)
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, numNodes);
+
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	// The ring lattice ignores node positions, so it scales to millions of nodes; the default keeps the
+	// spatial nearest-neighbour lattice this app has always drawn.
+	if (mParams["wattsStrogatzRing"])
 	{
-		mNodes.emplace_back(generateNode(radiusMean, radiusStd));
+		streamWattsStrogatzRing(context, mNodes, numNeighbors, rewireProb, stream);
 	}
+	else
+	{
+		streamWattsStrogatz(context, mNodes, numNeighbors, rewireProb, stream);
+	}
+	graphChanged();
+}
+
+inline void RandomGraph::generateRmat(int numNodes, float radiusMean, float radiusStd, const RmatParams &params)
+{
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, numNodes);
+
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	streamRmat(context, mNodes, params, stream);
+	graphChanged();
+}
+
+// Blocks start out as separate clusters, so the force layout only has to refine them.
+inline void RandomGraph::generateStochasticBlockModel(int numNodes, float radiusMean, float radiusStd, const SbmParams &params)
+{
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, numNodes);
+	clusterBlocks(mNodes, params.mBlockSizes, radiusMean, mParams["sbmSpread"]);
 
 	mEdges.clear();
-	for (auto i = 0; i < numNodes; ++i)
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	try
+	{
+		streamStochasticBlockModel(context, mNodes, params, stream);
+	}
+	catch (const std::exception &error)
 	{
-		for (auto j = 0; j < i; ++j)
+		ofLogError("RandomGraph") << error.what();
+	}
+	graphChanged();
+}
+
+// Degrees come from mDegreePath when that file exists, otherwise from the graph currently shown.
+inline std::vector<int> RandomGraph::targetDegrees()
+{
+	if (ofFile::doesFileExist(mDegreePath))
+	{
+		try
 		{
-			if (std::bernoulli_distribution(edgeProb)(mEngine))
-			{
-				auto weight = std::uniform_real_distribution<float>(mParams["edgeWeightMin"], mParams["edgeWeightMax"])(mEngine);
-				mEdges.emplace_back(Edge{i, j, mNodes[i].mPosition.distance(mNodes[j].mPosition), weight});
-			}
+			auto degrees = importDegreeSequence(ofToDataPath(mDegreePath));
+			mDegreeSource = mDegreePath;
+			return degrees;
+		}
+		catch (const std::exception &error)
+		{
+			ofLogError("RandomGraph") << error.what();
 		}
 	}
+	mDegreeSource = "current graph";
+	return degreeSequence(mNodes.size(), mEdges);
 }
 
-void RandomGraph::generateBarabasiAlbert(int numNodes, float radiusMean, float radiusStd, int numEdges)
+inline void RandomGraph::generateChungLu(const std::vector<int> &degrees, float radiusMean, float radiusStd)
 {
-	generateErdosRenyi(numEdges, radiusMean, radiusStd, 1.0);
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, degrees.size());
+
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	streamChungLu(context, mNodes, std::vector<float>(degrees.begin(), degrees.end()), stream);
+	graphChanged();
+}
+
+inline void RandomGraph::generateConfigurationModel(const std::vector<int> &degrees, float radiusMean, float radiusStd, bool erase)
+{
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, degrees.size());
+
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	streamConfigurationModel(context, mNodes, degrees, erase, stream);
+	graphChanged();
+}
 
-	for (auto i = numEdges; i < numNodes; ++i)
+inline void RandomGraph::generateRandomGeometric(int numNodes, float radiusMean, float radiusStd, const GeometricParams &params)
+{
+	GeneratorContext context(mEngine, generatorParams(radiusMean, radiusStd));
+	context.placeNodes(mNodes, numNodes);
+
+	mEdges.clear();
+	VectorEdgeSink sink(mEdges);
+	EdgeStream stream(sink, mParams["edgeChunkSize"]);
+	streamRandomGeometric(context, mNodes, params, stream);
+	graphChanged();
+}
+
+inline void RandomGraph::saveGraph(const std::string &path)
+{
+	try
+	{
+		writeGraphFile(ofToDataPath(path), mNodes, mEdges, CsrGraph(mNodes.size(), mEdges));
+	}
+	catch (const std::exception &error)
 	{
-		std::vector<int> degrees(mNodes.size(), 0);
-		for (const auto &edge : mEdges)
+		ofLogError("RandomGraph") << error.what();
+	}
+}
+
+// Binary .rgraph files are mapped without copying; the viewer only gathers them into mNodes and mEdges
+// because the physics keeps velocity and acceleration next to each position. GraphML and edge lists
+// are imported and laid out from generateNode.
+inline bool RandomGraph::loadGraph(const std::string &path)
+{
+	try
+	{
+		auto extension = ofToLower(ofFilePath::getFileExt(path));
+		if (extension != "rgraph")
 		{
-			++degrees[edge.mHead];
-			++degrees[edge.mTail];
+			auto graph = extension == "graphml" ? importGraphML(ofToDataPath(path)) : importEdgeList(ofToDataPath(path));
+			finishImport(mEngine, graph, mParams["radiusMean"], mParams["radiusStd"], mParams["edgeWeightMin"], mParams["edgeWeightMax"], mNodes, mEdges);
+			mGraphType = GraphType::Loaded;
+			mGraphPath = path;
+			graphChanged();
+			return true;
 		}
 
-		mNodes.emplace_back(generateNode(radiusMean, radiusStd));
+		MappedGraphFile file(ofToDataPath(path));
 
-		for (auto j = 0; j < numEdges; ++j)
+		// Copied into locals first, so a corrupt file leaves the current graph untouched.
+		auto positions = file.positions();
+		std::vector<Node> nodes(file.numNodes());
+		for (std::size_t i = 0; i < nodes.size(); ++i)
 		{
-			auto k = std::discrete_distribution<int>(degrees.begin(), degrees.end())(mEngine);
-			auto weight = std::uniform_real_distribution<float>(mParams["edgeWeightMin"], mParams["edgeWeightMax"])(mEngine);
-			mEdges.emplace_back(Edge{i, k, mNodes[i].mPosition.distance(mNodes[k].mPosition), weight});
+			nodes[i] = Node{positions[i]};
+		}
+
+		auto numNodes = static_cast<std::int32_t>(file.numNodes());
+		auto heads = file.heads();
+		auto tails = file.tails();
+		auto lengths = file.lengths();
+		auto weights = file.weights();
+		std::vector<Edge> edges(file.numEdges());
+		for (std::size_t i = 0; i < edges.size(); ++i)
+		{
+			if (heads[i] < 0 || heads[i] >= numNodes || tails[i] < 0 || tails[i] >= numNodes)
+			{
+				throw std::runtime_error(path + ": edge " + std::to_string(i) + " has an endpoint out of range");
+			}
+			edges[i] = Edge{heads[i], tails[i], lengths[i], weights[i]};
 		}
+		auto csr = file.csr();
+		mNodes.swap(nodes);
+		mEdges.swap(edges);
+
+		mGraphType = GraphType::Loaded;
+		mGraphPath = path;
+		graphChanged(csr);
+		return true;
+	}
+	catch (const std::exception &error)
+	{
+		ofLogError("RandomGraph") << error.what();
+		return false;
 	}
 }
 
-void RandomGraph::generateWattsStrogatz(int numNodes, float radiusMean, float radiusStd, int numNeighbors, float rewireProb)
+// Called whenever mNodes/mEdges are replaced wholesale.
+inline void RandomGraph::graphChanged()
 {
-	mNodes.clear();
-	for (auto i = 0; i < numNodes; ++i)
+	graphChanged(CsrGraph(mNodes.size(), mEdges));
+}
+
+// Takes the adjacency when the caller already has it, as a loaded graph file does.
+inline void RandomGraph::graphChanged(const CsrGraph &csr)
+{
+	if (mParams["spectralInit"])
 	{
-		mNodes.emplace_back(generateNode(radiusMean, radiusStd));
+		spectralLayout();
 	}
+	mForceAtlas2.reset(mNodes.size());
+	mGraph.assign(mEdges, mNodes.size());
+	mGrowth.reset(mEngine, mGraph);
+	analyzeGraph(csr);
+}
 
-	mEdges.clear();
-	for (auto i = 0; i < numNodes; ++i)
+inline void RandomGraph::analyzeGraph()
+{
+	analyzeGraph(CsrGraph(mNodes.size(), mEdges));
+}
+
+inline void RandomGraph::analyzeGraph(const CsrGraph &csr)
+{
+	PROFILE_SCOPE(mProfiler, "analyze");
+	mStats = computeGraphStats(csr, mParams["pathLengthSamples"], mEngine);
+	mComponents = connectedComponents(mNodes.size(), mEdges);
+}
+
+// Rates are read when growth starts; stopping it brings the statistics up to date.
+inline void RandomGraph::setGrowing(bool growing)
+{
+	mGrowing = growing;
+	if (mGrowing)
+	{
+		mGrowthParams.mNodesPerStep = mParams["growthNodesPerStep"];
+		mGrowthParams.mEdgesPerNode = mParams["growthEdgesPerNode"];
+		mGrowthParams.mMaxNodes = mParams["growthMaxNodes"];
+		mGrowthParams.mRewiresPerStep = mParams["growthRewiresPerStep"];
+		mGrowthParams.mChurnPerStep = mParams["growthChurnPerStep"];
+		mGrowthParams.mSpawnRadius = mParams["growthSpawnRadius"];
+	}
+	else
 	{
-		std::vector<std::pair<float, int>> norms;
-		for (auto j = 0; j < numNodes; ++j)
+		analyzeGraph();
+	}
+}
+
+// Replaces positions with Laplacian eigenvectors 2..4, computed per connected component and scaled so
+// each component's mean edge spans its mean rest length; the springs then start close to an untangled
+// layout. Components are laid side by side along x, largest at the origin. Components too small for
+// the eigensolver keep their positions.
+inline void RandomGraph::spectralLayout()
+{
+	PROFILE_SCOPE(mProfiler, "spectral");
+	auto embeddings = componentSpectralEmbeddings(CsrGraph(mNodes.size(), mEdges), connectedComponents(mNodes.size(), mEdges), mParams["spectralIterations"], mEngine);
+
+	std::vector<int> owners(mNodes.size(), -1);
+	std::vector<ofVec3f> positions(mNodes.size());
+	for (std::size_t c = 0; c < embeddings.size(); ++c)
+	{
+		for (std::size_t k = 0; k < embeddings[c].mNodes.size(); ++k)
 		{
-			norms.emplace_back(mNodes[j].mPosition.distance(mNodes[i].mPosition), j);
+			const auto &position = embeddings[c].mPositions[k];
+			owners[embeddings[c].mNodes[k]] = static_cast<int>(c);
+			positions[embeddings[c].mNodes[k]] = ofVec3f(position[0], position[1], position[2]);
 		}
-		std::sort(norms.begin(), norms.end());
-		for (auto j = 0; j < numNeighbors; ++j)
+	}
+
+	std::vector<double> spreads(embeddings.size(), 0.0);
+	std::vector<double> restLengths(embeddings.size(), 0.0);
+	double meanRestLength = 0;
+	for (const auto &edge : mEdges)
+	{
+		auto owner = owners[edge.mHead];
+		if (owner >= 0)
 		{
-			auto weight = std::uniform_real_distribution<float>(mParams["edgeWeightMin"], mParams["edgeWeightMax"])(mEngine);
-			if (std::bernoulli_distribution(rewireProb)(mEngine))
-			{
-				auto k = std::uniform_int_distribution<int>(0, numNodes - 1)(mEngine);
-				mEdges.emplace_back(Edge{i, k, mNodes[i].mPosition.distance(mNodes[k].mPosition), weight});
-			}
-			else
-			{
-				mEdges.emplace_back(Edge{i, norms[j].second, mNodes[i].mPosition.distance(mNodes[norms[j].second].mPosition), weight});
-			}
+			spreads[owner] += positions[edge.mHead].distance(positions[edge.mTail]);
+			restLengths[owner] += edge.mLength;
+		}
+		meanRestLength += edge.mLength;
+	}
+	meanRestLength = mEdges.empty() ? 1.0 : meanRestLength / mEdges.size();
+
+	auto cursor = 0.0f;
+	for (std::size_t c = 0; c < embeddings.size(); ++c)
+	{
+		const auto &nodes = embeddings[c].mNodes;
+		auto scale = spreads[c] > 0 ? static_cast<float>(restLengths[c] / spreads[c]) : 1.0f;
+		auto radius = 0.0f;
+		for (auto node : nodes)
+		{
+			radius = std::max(radius, positions[node].length() * scale);
+		}
+		auto offset = c == 0 ? ofVec3f() : ofVec3f(cursor + radius, 0, 0);
+		cursor = c == 0 ? radius + static_cast<float>(meanRestLength) : cursor + 2 * radius + static_cast<float>(meanRestLength);
+		for (auto node : nodes)
+		{
+			mNodes[node] = Node{offset + positions[node] * scale};
 		}
 	}
 }
 
-void RandomGraph::keyPressed(int key)
+// Runs the multilevel pipeline to a converged layout and hands it to the live simulation at rest.
+inline void RandomGraph::multilevelLayout()
+{
+	PROFILE_SCOPE(mProfiler, "multilevel");
+	MultilevelParams params;
+	params.mIterations = mParams["multilevelIterations"];
+	params.mRepulsion = mParams["multilevelRepulsion"];
+	auto positions = ::multilevelLayout(mNodes.size(), mEdges, params, mEngine);
+	for (std::size_t i = 0; i < mNodes.size(); ++i)
+	{
+		mNodes[i] = Node{positions[i]};
+	}
+}
+
+// Lays the graph out so Euclidean distances follow hop distances, one hop spanning the mean rest length.
+// Every edge then gets that rest length, otherwise the springs would pull back to the random lengths.
+inline void RandomGraph::stressLayout()
+{
+	PROFILE_SCOPE(mProfiler, "stress");
+	StressParams params;
+	params.mNumPivots = mParams["stressPivots"];
+	params.mIterations = mParams["stressIterations"];
+	auto positions = ::stressLayout(CsrGraph(mNodes.size(), mEdges), params, mEngine);
+
+	auto restLength = 0.0f;
+	for (const auto &edge : mEdges)
+	{
+		restLength += edge.mLength;
+	}
+	restLength = mEdges.empty() ? 1.0f : restLength / mEdges.size();
+	for (std::size_t i = 0; i < mNodes.size(); ++i)
+	{
+		mNodes[i] = Node{positions[i] * restLength};
+	}
+	for (auto &edge : mEdges)
+	{
+		edge.mLength = restLength;
+	}
+}
+
+inline void RandomGraph::exportGraph(const std::string &path)
+{
+	try
+	{
+		::exportGraph(ofToDataPath(path), mNodes, mEdges);
+	}
+	catch (const std::exception &error)
+	{
+		ofLogError("RandomGraph") << error.what();
+	}
+}
+
+inline void RandomGraph::keyPressed(int key)
 {
 	switch (key)
 	{
@@ -291,9 +962,122 @@ void RandomGraph::keyPressed(int key)
 	{
 		mGraphType = GraphType::WattsStrogatz;
 		mNumNeighbors = std::uniform_int_distribution<int>(mParams["numNeighborsMin"], mParams["numNeighborsMax"])(mEngine);
-		mRewireProb = std::uniform_real_distribution<float>(mParams["rewireProbsMin"], mParams["rewireProbMax"])(mEngine);
+		mRewireProb = std::uniform_real_distribution<float>(mParams["rewireProbMin"], mParams["rewireProbMax"])(mEngine);
 		generateWattsStrogatz(mParams["numNodes"], mParams["radiusMean"], mParams["radiusStd"], mNumNeighbors, mRewireProb);
 	}
 	break;
+	case 'r':
+	{
+		mGraphType = GraphType::Rmat;
+		mRmatParams.mA = mParams["rmatA"];
+		mRmatParams.mB = mParams["rmatB"];
+		mRmatParams.mC = mParams["rmatC"];
+		mRmatParams.mEdgeFactor = mParams["rmatEdgeFactor"];
+		mRmatParams.mPermute = mParams["rmatPermute"] != 0;
+		mRmatParams.mDedupe = mParams["rmatDedupe"] != 0;
+		generateRmat(mParams["numNodes"], mParams["radiusMean"], mParams["radiusStd"], mRmatParams);
+	}
+	break;
+	case 's':
+	{
+		mGraphType = GraphType::StochasticBlockModel;
+		mNumBlocks = std::uniform_int_distribution<int>(mParams["sbmBlocksMin"], mParams["sbmBlocksMax"])(mEngine);
+		mInProb = std::uniform_real_distribution<float>(mParams["sbmInProbMin"], mParams["sbmInProbMax"])(mEngine);
+		mOutProb = mParams["sbmOutProb"];
+		generateStochasticBlockModel(mParams["numNodes"], mParams["radiusMean"], mParams["radiusStd"], plantedPartition(mParams["numNodes"], mNumBlocks, mInProb, mOutProb));
+	}
+	break;
+	case 'u':
+	{
+		mGraphType = GraphType::ChungLu;
+		generateChungLu(targetDegrees(), mParams["radiusMean"], mParams["radiusStd"]);
+	}
+	break;
+	case 'n':
+	{
+		mGraphType = GraphType::ConfigurationModel;
+		generateConfigurationModel(targetDegrees(), mParams["radiusMean"], mParams["radiusStd"], mParams["configErase"] != 0);
+	}
+	break;
+	case 'g':
+	{
+		mGraphType = GraphType::RandomGeometric;
+		mGeometricParams.mRadius = std::uniform_real_distribution<float>(mParams["geometricRadiusMin"], mParams["geometricRadiusMax"])(mEngine);
+		mGeometricParams.mPeriodic = mParams["geometricPeriodic"] != 0;
+		generateRandomGeometric(mParams["numNodes"], mParams["radiusMean"], mParams["radiusStd"], mGeometricParams);
+	}
+	break;
+	case 'a':
+	{
+		setGrowing(!mGrowing);
+	}
+	break;
+	case 'S':
+	{
+		saveGraph(mGraphPath);
+	}
+	break;
+	case 'L':
+	{
+		loadGraph(mGraphPath);
+	}
+	break;
+	case 'i':
+	{
+		spectralLayout();
+	}
+	break;
+	case 'm':
+	{
+		multilevelLayout();
+	}
+	break;
+	case 'f':
+	{
+		mForceModel = mForceModel == ForceModel::Springs ? ForceModel::ForceAtlas2 : ForceModel::Springs;
+	}
+	break;
+	case 'd':
+	{
+		stressLayout();
+	}
+	break;
+	case 'o':
+	{
+		mCollisions = !mCollisions;
+	}
+	break;
+	case 'p':
+	{
+		mColorByComponent = !mColorByComponent;
+		if (mColorByComponent && mGrowing)
+		{
+			mComponents = connectedComponents(mNodes.size(), mEdges);
+		}
+	}
+	break;
+	case 'x':
+	{
+		auto name = "graph_" + ofGetTimestampString();
+		for (const auto &extension : {".edges", ".graphml", ".gexf", ".dot"})
+		{
+			exportGraph(name + extension);
+		}
+	}
+	break;
+#ifdef RANDOM_GRAPH_PROFILE
+	case 't':
+	{
+		try
+		{
+			mProfiler.exportTrace(ofToDataPath("trace_" + ofGetTimestampString() + ".json"));
+		}
+		catch (const std::exception &error)
+		{
+			ofLogError("RandomGraph") << error.what();
+		}
+	}
+	break;
+#endif
 	}
 }
\ No newline at end of file
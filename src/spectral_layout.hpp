@@ -0,0 +1,287 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include "parallel.hpp"
+#include "union_find.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Eigen-decomposition of a small dense symmetric matrix (row-major, size x size) by cyclic Jacobi
+// rotations. Eigenvalues end up on the diagonal of matrix, eigenvectors in the columns of vectors.
+inline void jacobiEigen(std::vector<double> &matrix, std::vector<double> &vectors, int size)
+{
+	vectors.assign(size * size, 0.0);
+	for (auto i = 0; i < size; ++i)
+	{
+		vectors[i * size + i] = 1.0;
+	}
+
+	for (auto sweep = 0; sweep < 100; ++sweep)
+	{
+		double offDiagonal = 0;
+		for (auto p = 0; p < size; ++p)
+		{
+			for (auto q = p + 1; q < size; ++q)
+			{
+				offDiagonal += matrix[p * size + q] * matrix[p * size + q];
+			}
+		}
+		if (offDiagonal < 1e-22)
+		{
+			break;
+		}
+
+		for (auto p = 0; p < size; ++p)
+		{
+			for (auto q = p + 1; q < size; ++q)
+			{
+				auto apq = matrix[p * size + q];
+				if (std::abs(apq) < 1e-300)
+				{
+					continue;
+				}
+				auto theta = (matrix[q * size + q] - matrix[p * size + p]) / (2 * apq);
+				auto t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+				auto c = 1 / std::sqrt(t * t + 1);
+				auto s = t * c;
+				for (auto k = 0; k < size; ++k)
+				{
+					auto akp = matrix[k * size + p];
+					auto akq = matrix[k * size + q];
+					matrix[k * size + p] = c * akp - s * akq;
+					matrix[k * size + q] = s * akp + c * akq;
+				}
+				for (auto k = 0; k < size; ++k)
+				{
+					auto apk = matrix[p * size + k];
+					auto aqk = matrix[q * size + k];
+					matrix[p * size + k] = c * apk - s * aqk;
+					matrix[q * size + k] = s * apk + c * aqk;
+				}
+				for (auto k = 0; k < size; ++k)
+				{
+					auto vkp = vectors[k * size + p];
+					auto vkq = vectors[k * size + q];
+					vectors[k * size + p] = c * vkp - s * vkq;
+					vectors[k * size + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+}
+
+// Three wanted eigenvectors plus one guard vector; below kMinSpectralNodes nodes the block is too large
+// for the subspace and spectralEmbedding returns zeros.
+constexpr int kSpectralBlockSize = 4;
+constexpr int kMinSpectralNodes = kSpectralBlockSize * 3 + 1;
+
+// Eigenvectors 2..4 of the Laplacian L = D - A of a connected graph by block LOBPCG (Knyazev) with a
+// Jacobi (degree) preconditioner. Every block vector is kept orthogonal to the constant null vector,
+// and the block holds one guard vector beyond the three wanted so that degenerate pairs, as on ring
+// lattices, are resolved together. Memory is O(n * blockSize); SpMV, dots and updates run in parallel
+// over nodes. On a disconnected graph the null space holds one indicator per component, so use
+// componentSpectralEmbeddings there.
+inline std::vector<std::array<float, 3>> spectralEmbedding(const CsrGraph &graph, int numIterations, std::mt19937 &engine, double tolerance = 1e-4)
+{
+	using Vector = std::vector<double>;
+	static constexpr int kBlockSize = kSpectralBlockSize;
+
+	auto numNodes = graph.numNodes();
+	std::vector<std::array<float, 3>> embedding(numNodes, std::array<float, 3>{});
+	if (numNodes < kMinSpectralNodes)
+	{
+		return embedding;
+	}
+
+	auto threads = numThreads();
+	auto dot = [&](const Vector &x, const Vector &y) {
+		std::vector<double> partials(threads, 0.0);
+		parallelRanges(numNodes, [&](int thread, std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i)
+			{
+				partials[thread] += x[i] * y[i];
+			}
+		}, threads);
+		return std::accumulate(partials.begin(), partials.end(), 0.0);
+	};
+	auto axpy = [&](double a, const Vector &x, Vector &y) {
+		parallelFor(numNodes, [&](std::size_t i) { y[i] += a * x[i]; });
+	};
+	auto removeMean = [&](Vector &x) {
+		auto mean = std::accumulate(x.begin(), x.end(), 0.0) / numNodes;
+		parallelFor(numNodes, [&](std::size_t i) { x[i] -= mean; });
+	};
+	auto laplacian = [&](const Vector &x, Vector &y) {
+		y.resize(numNodes);
+		parallelFor(numNodes, [&](std::size_t i) {
+			auto sum = graph.degree(i) * x[i];
+			for (auto j = graph.begin(i); j != graph.end(i); ++j)
+			{
+				sum -= x[*j];
+			}
+			y[i] = sum;
+		});
+	};
+	// Modified Gram-Schmidt, twice for stability; columns that collapse are dropped.
+	auto orthonormalize = [&](std::vector<Vector> &columns) {
+		std::vector<Vector> basis;
+		for (auto &column : columns)
+		{
+			auto original = std::sqrt(dot(column, column));
+			for (auto pass = 0; pass < 2; ++pass)
+			{
+				for (const auto &previous : basis)
+				{
+					axpy(-dot(previous, column), previous, column);
+				}
+			}
+			auto norm = std::sqrt(dot(column, column));
+			if (norm > 1e-8 * original && norm > 0)
+			{
+				parallelFor(numNodes, [&](std::size_t i) { column[i] /= norm; });
+				basis.push_back(std::move(column));
+			}
+		}
+		columns.swap(basis);
+	};
+
+	auto normal = std::normal_distribution<double>();
+	std::vector<Vector> block(kBlockSize, Vector(numNodes));
+	for (auto &column : block)
+	{
+		for (auto &value : column)
+		{
+			value = normal(engine);
+		}
+		removeMean(column);
+	}
+	orthonormalize(block);
+
+	std::vector<Vector> residuals;
+	std::vector<Vector> directions;
+	std::vector<Vector> products;
+	for (auto iteration = 0; iteration < numIterations; ++iteration)
+	{
+		// Rayleigh-Ritz on span[X, W, P].
+		auto numBlock = static_cast<int>(block.size());
+		std::vector<Vector> subspace = std::move(block);
+		for (auto &column : residuals)
+		{
+			subspace.push_back(std::move(column));
+		}
+		for (auto &column : directions)
+		{
+			subspace.push_back(std::move(column));
+		}
+		orthonormalize(subspace);
+		auto size = static_cast<int>(subspace.size());
+		numBlock = std::min(numBlock, size);
+
+		products.resize(size);
+		for (auto j = 0; j < size; ++j)
+		{
+			laplacian(subspace[j], products[j]);
+		}
+		std::vector<double> gram(size * size);
+		for (auto a = 0; a < size; ++a)
+		{
+			for (auto b = a; b < size; ++b)
+			{
+				gram[a * size + b] = gram[b * size + a] = dot(subspace[a], products[b]);
+			}
+		}
+		std::vector<double> ritz;
+		jacobiEigen(gram, ritz, size);
+		std::vector<int> order(size);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](int a, int b) { return gram[a * size + a] < gram[b * size + b]; });
+
+		block.assign(numBlock, Vector(numNodes, 0.0));
+		directions.assign(numBlock, Vector(numNodes, 0.0));
+		residuals.assign(numBlock, Vector(numNodes, 0.0));
+		auto converged = true;
+		for (auto k = 0; k < numBlock; ++k)
+		{
+			auto column = order[k];
+			auto value = gram[column * size + column];
+			parallelFor(numNodes, [&](std::size_t i) {
+				double x = 0;
+				double p = 0;
+				double ax = 0;
+				for (auto j = 0; j < size; ++j)
+				{
+					auto weight = ritz[j * size + column];
+					(j < numBlock ? x : p) += subspace[j][i] * weight;
+					ax += products[j][i] * weight;
+				}
+				block[k][i] = x + p;
+				directions[k][i] = p;
+				residuals[k][i] = ax - value * (x + p);
+			});
+			auto residualNorm = std::sqrt(dot(residuals[k], residuals[k]));
+			converged &= k >= 3 || residualNorm < tolerance * std::max(value, 1e-3);
+			parallelFor(numNodes, [&](std::size_t i) { residuals[k][i] /= std::max(graph.degree(i), 1); });
+			removeMean(residuals[k]);
+		}
+		if (converged)
+		{
+			break;
+		}
+	}
+
+	for (auto axis = 0; axis < 3 && axis < static_cast<int>(block.size()); ++axis)
+	{
+		parallelFor(numNodes, [&](std::size_t i) { embedding[i][axis] = static_cast<float>(block[axis][i]); });
+	}
+	return embedding;
+}
+
+struct ComponentEmbedding
+{
+	std::vector<int> mNodes;
+	std::vector<std::array<float, 3>> mPositions;
+};
+
+// spectralEmbedding of each connected component on its own subgraph, largest component first. Components
+// with fewer than kMinSpectralNodes nodes are left out, so callers keep their current positions.
+inline std::vector<ComponentEmbedding> componentSpectralEmbeddings(const CsrGraph &graph, const Components &components, int numIterations, std::mt19937 &engine, double tolerance = 1e-4)
+{
+	std::vector<std::vector<int>> members(components.mNumComponents);
+	for (auto i = 0; i < graph.numNodes(); ++i)
+	{
+		members[components.mLabels[i]].push_back(i);
+	}
+	std::stable_sort(members.begin(), members.end(), [](const std::vector<int> &a, const std::vector<int> &b) { return a.size() > b.size(); });
+
+	std::vector<int> local(graph.numNodes());
+	std::vector<ComponentEmbedding> embeddings;
+	for (auto &nodes : members)
+	{
+		if (nodes.size() < static_cast<std::size_t>(kMinSpectralNodes))
+		{
+			break;
+		}
+		for (std::size_t k = 0; k < nodes.size(); ++k)
+		{
+			local[nodes[k]] = static_cast<int>(k);
+		}
+		std::vector<std::pair<int, int>> pairs;
+		for (auto u : nodes)
+		{
+			for (auto v = graph.begin(u); v != graph.end(u); ++v)
+			{
+				if (u < *v)
+				{
+					pairs.emplace_back(local[u], local[*v]);
+				}
+			}
+		}
+		auto positions = spectralEmbedding(CsrGraph(static_cast<int>(nodes.size()), pairs), numIterations, engine, tolerance);
+		embeddings.push_back(ComponentEmbedding{std::move(nodes), std::move(positions)});
+	}
+	return embeddings;
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "bfs.hpp"
+#include "csr_graph.hpp"
+#include "parallel.hpp"
+#include "spectral_layout.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+struct StressParams
+{
+	int mNumPivots = 50;
+	int mIterations = 100;
+	float mTolerance = 1e-4f;
+};
+
+// Pivots chosen by max-min sampling: each new pivot is the node farthest (in hops) from all pivots so
+// far, so unreached components are picked up before any component gets a second pivot. Distances are
+// stored pivot-major, numPivots x numNodes, with -1 for unreachable nodes.
+inline std::vector<int> selectPivots(const CsrGraph &graph, int numPivots, std::mt19937 &engine, std::vector<int> &distances)
+{
+	auto numNodes = graph.numNodes();
+	std::vector<int> pivots;
+	std::vector<int> nearest(numNodes, std::numeric_limits<int>::max());
+	distances.clear();
+	distances.reserve(static_cast<std::size_t>(numPivots) * numNodes);
+	auto pivot = std::uniform_int_distribution<int>(0, numNodes - 1)(engine);
+	for (auto p = 0; p < numPivots; ++p)
+	{
+		pivots.push_back(pivot);
+		auto row = breadthFirstSearch(graph, pivot);
+		distances.insert(distances.end(), row.begin(), row.end());
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			if (row[i] >= 0)
+			{
+				nearest[i] = std::min(nearest[i], row[i]);
+			}
+		}
+		pivot = static_cast<int>(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+	}
+	return pivots;
+}
+
+// Pivot MDS (Brandes & Pich 2006): double-centre the n x k matrix of squared pivot distances and
+// project onto the top three eigenvectors of C^T C. Unreachable pairs count as one hop beyond the
+// largest finite distance, which keeps components apart.
+inline std::vector<ofVec3f> pivotMds(const std::vector<int> &distances, int numNodes, int numPivots)
+{
+	auto maxDistance = *std::max_element(distances.begin(), distances.end());
+	std::vector<double> centred(distances.size());
+	parallelFor(distances.size(), [&](std::size_t i) {
+		double distance = distances[i] < 0 ? maxDistance + 1 : distances[i];
+		centred[i] = distance * distance;
+	});
+
+	// Pivot-major layout: row p holds pivot p's squared distances to every node.
+	std::vector<double> pivotMeans(numPivots, 0.0);
+	std::vector<double> nodeMeans(numNodes, 0.0);
+	for (auto p = 0; p < numPivots; ++p)
+	{
+		pivotMeans[p] = std::accumulate(centred.begin() + static_cast<std::size_t>(p) * numNodes, centred.begin() + static_cast<std::size_t>(p + 1) * numNodes, 0.0) / numNodes;
+	}
+	parallelFor(numNodes, [&](std::size_t i) {
+		for (auto p = 0; p < numPivots; ++p)
+		{
+			nodeMeans[i] += centred[static_cast<std::size_t>(p) * numNodes + i];
+		}
+		nodeMeans[i] /= numPivots;
+	});
+	auto grandMean = std::accumulate(pivotMeans.begin(), pivotMeans.end(), 0.0) / numPivots;
+	parallelFor(numNodes, [&](std::size_t i) {
+		for (auto p = 0; p < numPivots; ++p)
+		{
+			auto &c = centred[static_cast<std::size_t>(p) * numNodes + i];
+			c = -0.5 * (c - pivotMeans[p] - nodeMeans[i] + grandMean);
+		}
+	});
+
+	auto threads = numThreads();
+	std::vector<std::vector<double>> partials(threads, std::vector<double>(numPivots * numPivots, 0.0));
+	parallelRanges(numNodes, [&](int thread, std::size_t first, std::size_t last) {
+		auto &gram = partials[thread];
+		for (auto p = 0; p < numPivots; ++p)
+		{
+			for (auto q = p; q < numPivots; ++q)
+			{
+				const auto *rowP = centred.data() + static_cast<std::size_t>(p) * numNodes;
+				const auto *rowQ = centred.data() + static_cast<std::size_t>(q) * numNodes;
+				double sum = 0;
+				for (auto i = first; i < last; ++i)
+				{
+					sum += rowP[i] * rowQ[i];
+				}
+				gram[p * numPivots + q] += sum;
+			}
+		}
+	}, threads);
+	std::vector<double> gram(numPivots * numPivots, 0.0);
+	for (auto p = 0; p < numPivots; ++p)
+	{
+		for (auto q = p; q < numPivots; ++q)
+		{
+			for (const auto &partial : partials)
+			{
+				gram[p * numPivots + q] += partial[p * numPivots + q];
+			}
+			gram[q * numPivots + p] = gram[p * numPivots + q];
+		}
+	}
+
+	std::vector<double> vectors;
+	jacobiEigen(gram, vectors, numPivots);
+	std::vector<int> order(numPivots);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return gram[a * numPivots + a] > gram[b * numPivots + b]; });
+
+	std::vector<ofVec3f> positions(numNodes);
+	parallelFor(numNodes, [&](std::size_t i) {
+		for (auto axis = 0; axis < std::min(numPivots, 3); ++axis)
+		{
+			double sum = 0;
+			for (auto p = 0; p < numPivots; ++p)
+			{
+				sum += centred[static_cast<std::size_t>(p) * numNodes + i] * vectors[p * numPivots + order[axis]];
+			}
+			positions[i][axis] = static_cast<float>(sum);
+		}
+	});
+	return positions;
+}
+
+// Sparse stress majorisation (Ortmann, Klimenta & Brandes 2016) in units of one hop. Each node keeps
+// exact terms for its neighbours and approximates everyone else through the k pivots: the term towards
+// pivot p has target distance d(i, p) and weight s / d(i, p)^2, where s counts the nodes of p's region
+// (nodes closer to p than to any other pivot) lying within d(i, p) / 2 of p. Memory is O(n * k) for
+// the pivot distances; positions start from pivot MDS and are updated Jacobi-style in parallel until
+// the relative movement drops below mTolerance.
+inline std::vector<ofVec3f> stressLayout(const CsrGraph &graph, const StressParams &params, std::mt19937 &engine)
+{
+	auto numNodes = graph.numNodes();
+	if (numNodes == 0)
+	{
+		return {};
+	}
+	auto numPivots = std::min(params.mNumPivots, numNodes);
+	std::vector<int> distances;
+	auto pivots = selectPivots(graph, numPivots, engine, distances);
+	auto positions = pivotMds(distances, numNodes, numPivots);
+	auto distance = [&](int p, int i) { return distances[static_cast<std::size_t>(p) * numNodes + i]; };
+
+	// Cumulative per-pivot region histograms by hop distance give s in O(1) per term.
+	auto maxDistance = *std::max_element(distances.begin(), distances.end());
+	std::vector<int> regionCounts(static_cast<std::size_t>(numPivots) * (maxDistance + 1), 0);
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		auto region = -1;
+		for (auto p = 0; p < numPivots; ++p)
+		{
+			if (distance(p, i) >= 0 && (region < 0 || distance(p, i) < distance(region, i)))
+			{
+				region = p;
+			}
+		}
+		if (region >= 0)
+		{
+			++regionCounts[static_cast<std::size_t>(region) * (maxDistance + 1) + distance(region, i)];
+		}
+	}
+	for (auto p = 0; p < numPivots; ++p)
+	{
+		auto *counts = regionCounts.data() + static_cast<std::size_t>(p) * (maxDistance + 1);
+		std::partial_sum(counts, counts + maxDistance + 1, counts);
+	}
+
+	// Pivot MDS only fixes the shape; scale it to the stress-optimal size for the pivot terms.
+	double scaleNumerator = 0;
+	double scaleDenominator = 0;
+	for (auto p = 0; p < numPivots; ++p)
+	{
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			auto d = distance(p, i);
+			if (d > 0)
+			{
+				auto length = positions[i].distance(positions[pivots[p]]);
+				scaleNumerator += length / d;
+				scaleDenominator += length * length / (static_cast<double>(d) * d);
+			}
+		}
+	}
+	auto scale = scaleDenominator > 0 ? static_cast<float>(scaleNumerator / scaleDenominator) : 1.0f;
+	for (auto &position : positions)
+	{
+		position *= scale;
+	}
+
+	auto uniform = std::uniform_real_distribution<float>(-0.5f, 0.5f);
+	std::vector<ofVec3f> jitter(numNodes);
+	for (auto &offset : jitter)
+	{
+		offset = ofVec3f(uniform(engine), uniform(engine), uniform(engine));
+	}
+
+	auto threads = numThreads();
+	std::vector<ofVec3f> next(numNodes);
+	std::vector<double> movement(threads);
+	std::vector<double> extent(threads);
+	for (auto iteration = 0; iteration < params.mIterations; ++iteration)
+	{
+		parallelRanges(numNodes, [&](int thread, std::size_t first, std::size_t last) {
+			movement[thread] = 0;
+			extent[thread] = 0;
+			for (auto i = first; i < last; ++i)
+			{
+				const auto &position = positions[i];
+				auto pull = [&](const ofVec3f &target, float length, float weight, ofVec3f &sum) {
+					auto delta = position - target;
+					auto norm = delta.length();
+					// Coincident nodes are pushed apart along a fixed per-node direction.
+					sum += (target + (norm > 1e-6f ? delta / norm : jitter[i].getNormalized()) * length) * weight;
+				};
+
+				ofVec3f sum;
+				float weights = 0;
+				for (auto j = graph.begin(i); j != graph.end(i); ++j)
+				{
+					pull(positions[*j], 1.0f, 1.0f, sum);
+					weights += 1.0f;
+				}
+				for (auto p = 0; p < numPivots; ++p)
+				{
+					auto d = distance(p, i);
+					if (d > 1)
+					{
+						auto s = regionCounts[static_cast<std::size_t>(p) * (maxDistance + 1) + d / 2];
+						auto weight = static_cast<float>(s) / (static_cast<float>(d) * d);
+						pull(positions[pivots[p]], static_cast<float>(d), weight, sum);
+						weights += weight;
+					}
+				}
+				next[i] = weights > 0 ? sum / weights : position;
+				movement[thread] += next[i].distance(position);
+				extent[thread] += next[i].length();
+			}
+		}, threads);
+		positions.swap(next);
+
+		auto totalMovement = std::accumulate(movement.begin(), movement.end(), 0.0);
+		auto totalExtent = std::accumulate(extent.begin(), extent.end(), 0.0);
+		if (totalMovement <= params.mTolerance * totalExtent)
+		{
+			break;
+		}
+	}
+	return positions;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "ofVec3f.h"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Uniform hash grid over points: cells of side mCellSize are hashed into a power-of-two table of at
+// least twice as many buckets as points, and the point indices are counting-sorted by bucket in
+// parallel, so each bucket is a contiguous slice. Neighbour queries probe a fixed number of cells,
+// which keeps them O(1) amortised when the cell size is matched to the query radius.
+class UniformGrid
+{
+public:
+	// position(i) returns point i, so callers can index straight into their own node layout.
+	template <typename Position>
+	void build(std::size_t count, float cellSize, Position position)
+	{
+		mCellSize = cellSize;
+		std::size_t tableSize = 1;
+		while (tableSize < 2 * count)
+		{
+			tableSize *= 2;
+		}
+		mMask = tableSize - 1;
+		if (mTableSize != tableSize)
+		{
+			mCounts.reset(new std::atomic<int>[tableSize]);
+			mTableSize = tableSize;
+		}
+		mStarts.assign(tableSize + 1, 0);
+		mKeys.resize(count);
+		mIndices.resize(count);
+		mPoints.resize(count);
+
+		parallelFor(tableSize, [&](std::size_t bucket) { mCounts[bucket].store(0, std::memory_order_relaxed); });
+		parallelFor(count, [&](std::size_t i) {
+			ofVec3f point = position(i);
+			mKeys[i] = bucket(cell(point.x), cell(point.y), cell(point.z));
+			mCounts[mKeys[i]].fetch_add(1, std::memory_order_relaxed);
+		});
+
+		// Exclusive scan in two parallel passes: per-range totals, then per-range prefix sums.
+		auto threads = numThreads();
+		std::vector<int> totals(threads + 1, 0);
+		parallelRanges(tableSize, [&](int thread, std::size_t first, std::size_t last) {
+			auto total = 0;
+			for (auto b = first; b < last; ++b)
+			{
+				total += mCounts[b].load(std::memory_order_relaxed);
+			}
+			totals[thread + 1] = total;
+		}, threads);
+		for (auto thread = 0; thread < threads; ++thread)
+		{
+			totals[thread + 1] += totals[thread];
+		}
+		parallelRanges(tableSize, [&](int thread, std::size_t first, std::size_t last) {
+			auto start = totals[thread];
+			for (auto b = first; b < last; ++b)
+			{
+				mStarts[b] = start;
+				start += mCounts[b].exchange(start, std::memory_order_relaxed);
+			}
+		}, threads);
+		mStarts[tableSize] = static_cast<int>(count);
+		// Most of the cells around a query are empty; a bitmap small enough to stay cached lets
+		// queries skip them without touching mStarts.
+		mOccupied.assign((tableSize + 63) / 64, 0);
+		parallelRanges(mOccupied.size(), [&](int, std::size_t first, std::size_t last) {
+			for (auto word = first; word < last; ++word)
+			{
+				for (auto b = word * 64; b < std::min<std::size_t>((word + 1) * 64, tableSize); ++b)
+				{
+					mOccupied[word] |= std::uint64_t(mStarts[b + 1] > mStarts[b]) << (b % 64);
+				}
+			}
+		});
+
+		parallelFor(count, [&](std::size_t i) { mIndices[mCounts[mKeys[i]].fetch_add(1, std::memory_order_relaxed)] = static_cast<int>(i); });
+		// With several threads the scatter order within a bucket depends on timing; sorting the (tiny)
+		// buckets keeps queries, and any float sums over them, deterministic.
+		if (threads > 1)
+		{
+			parallelFor(tableSize, [&](std::size_t b) { std::sort(mIndices.begin() + mStarts[b], mIndices.begin() + mStarts[b + 1]); });
+		}
+		parallelFor(count, [&](std::size_t k) { mPoints[k] = position(mIndices[k]); });
+	}
+
+	float cellSize() const { return mCellSize; }
+	int cell(float coordinate) const { return static_cast<int>(std::floor(coordinate / mCellSize)); }
+
+	// x is added after hashing y and z, so cells along x fill consecutive buckets: a query's 27 cells
+	// then fall into 9 short runs of memory instead of 27 scattered buckets.
+	std::size_t bucket(int x, int y, int z) const
+	{
+		auto hash = (static_cast<std::uint32_t>(y) * 73856093u ^ static_cast<std::uint32_t>(z) * 19349663u) + static_cast<std::uint32_t>(x);
+		return hash & mMask;
+	}
+
+	// Calls function(index, point) for every point in the 2x2x2 block of cells nearest to position,
+	// each point once. With radius at most half the cell size this block covers the whole query ball,
+	// and only 8 buckets are probed instead of 27. Points are read from the grid's bucket-ordered copy,
+	// and hash collisions may add points from farther cells, so callers still test the distance.
+	template <typename Function>
+	void forEachNeighbor(const ofVec3f &position, Function function) const
+	{
+		int low[3];
+		for (auto axis = 0; axis < 3; ++axis)
+		{
+			auto scaled = position[axis] / mCellSize;
+			auto index = static_cast<int>(std::floor(scaled));
+			low[axis] = scaled - index < 0.5f ? index - 1 : index;
+		}
+
+		std::size_t buckets[8];
+		for (auto corner = 0; corner < 8; ++corner)
+		{
+			buckets[corner] = bucket(low[0] + (corner & 1), low[1] + (corner >> 1 & 1), low[2] + (corner >> 2));
+		}
+		std::size_t occupied[8];
+		auto numOccupied = occupiedBuckets(buckets, 8, occupied);
+		for (auto i = 0; i < numOccupied; ++i)
+		{
+			forEachInBucket(occupied[i], function);
+		}
+	}
+
+	// Copies the non-empty buckets among the given ones to occupied, each once (several cells can hash
+	// to the same bucket), and returns how many there are. Empty buckets are skipped via the bitmap.
+	int occupiedBuckets(const std::size_t *buckets, int count, std::size_t *occupied) const
+	{
+		auto numOccupied = 0;
+		for (auto i = 0; i < count; ++i)
+		{
+			auto b = buckets[i];
+			if ((mOccupied[b / 64] >> (b % 64) & 1) && std::find(occupied, occupied + numOccupied, b) == occupied + numOccupied)
+			{
+				occupied[numOccupied++] = b;
+			}
+		}
+		return numOccupied;
+	}
+
+	// Calls function(index, point) for every point in the bucket.
+	template <typename Function>
+	void forEachInBucket(std::size_t bucket, Function function) const
+	{
+		for (auto k = mStarts[bucket]; k < mStarts[bucket + 1]; ++k)
+		{
+			function(mIndices[k], mPoints[k]);
+		}
+	}
+
+	// Points in bucket order, so a sweep over k visits neighbouring points together.
+	std::size_t size() const { return mIndices.size(); }
+	int index(std::size_t k) const { return mIndices[k]; }
+	const ofVec3f &point(std::size_t k) const { return mPoints[k]; }
+
+private:
+	float mCellSize = 1.0f;
+	std::size_t mMask = 0;
+	std::size_t mTableSize = 0;
+	std::unique_ptr<std::atomic<int>[]> mCounts;
+	std::vector<int> mStarts;
+	std::vector<std::uint64_t> mOccupied;
+	std::vector<std::size_t> mKeys;
+	std::vector<int> mIndices;
+	std::vector<ofVec3f> mPoints;
+};
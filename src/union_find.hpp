@@ -0,0 +1,99 @@
+#pragma once
+
+#include "graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Lock-free union-find: parents are atomics, roots are linked larger index under smaller with a single
+// CAS (retried if another thread linked the root first), and find compresses by path halving with CAS.
+class ConcurrentUnionFind
+{
+public:
+	explicit ConcurrentUnionFind(int numNodes) : mParents(new std::atomic<int>[numNodes])
+	{
+		parallelFor(numNodes, [&](std::size_t i) { mParents[i].store(static_cast<int>(i), std::memory_order_relaxed); });
+	}
+
+	int find(int node)
+	{
+		auto parent = mParents[node].load(std::memory_order_relaxed);
+		while (parent != node)
+		{
+			auto grandparent = mParents[parent].load(std::memory_order_relaxed);
+			mParents[node].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+			node = parent;
+			parent = mParents[node].load(std::memory_order_relaxed);
+		}
+		return node;
+	}
+
+	void unite(int first, int second)
+	{
+		while (true)
+		{
+			first = find(first);
+			second = find(second);
+			if (first == second)
+			{
+				return;
+			}
+			if (first < second)
+			{
+				std::swap(first, second);
+			}
+			auto root = first;
+			if (mParents[first].compare_exchange_strong(root, second, std::memory_order_relaxed))
+			{
+				return;
+			}
+		}
+	}
+
+private:
+	std::unique_ptr<std::atomic<int>[]> mParents;
+};
+
+struct Components
+{
+	std::vector<int> mLabels;
+	int mNumComponents = 0;
+	int mGiantLabel = -1;
+	int mGiantSize = 0;
+};
+
+// Labels are dense in [0, mNumComponents), numbered in order of each component's smallest node.
+inline Components connectedComponents(int numNodes, const std::vector<Edge> &edges)
+{
+	ConcurrentUnionFind unionFind(numNodes);
+	parallelFor(edges.size(), [&](std::size_t i) { unionFind.unite(edges[i].mHead, edges[i].mTail); });
+
+	Components components;
+	components.mLabels.resize(numNodes);
+	parallelFor(numNodes, [&](std::size_t i) { components.mLabels[i] = unionFind.find(static_cast<int>(i)); });
+
+	std::vector<int> sizes;
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		auto &label = components.mLabels[i];
+		if (label == i)
+		{
+			label = components.mNumComponents++;
+			sizes.push_back(0);
+		}
+		else
+		{
+			label = components.mLabels[label];
+		}
+		++sizes[label];
+	}
+
+	if (!sizes.empty())
+	{
+		components.mGiantLabel = static_cast<int>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+		components.mGiantSize = sizes[components.mGiantLabel];
+	}
+	return components;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ofVec3f.h"
+#include "parallel.hpp"
+#include "uniform_grid.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Neighbour lists for short-range forces (a Verlet list): for each point, the points closer than
+// radius + skin when the lists were built, found through the hash grid. The lists stay valid while no
+// point has moved more than skin / 2 since then, so most frames cost one pass over the stored pairs
+// instead of a grid build and eight bucket probes per point. Lists are stored per point in both
+// directions, so callers can accumulate forces in parallel over points without races.
+class VerletList
+{
+public:
+	// Rebuilds the lists if the point count, radius or skin changed or some point moved too far; returns
+	// whether it did. position(i) returns point i.
+	template <typename Position>
+	bool update(std::size_t count, float radius, float skin, Position position)
+	{
+		if (mValid && count == mReference.size() && radius == mRadius && skin == mSkin && !moved(count, position))
+		{
+			return false;
+		}
+		build(count, radius, skin, position);
+		return true;
+	}
+
+	void invalidate() { mValid = false; }
+
+	int begin(std::size_t i) const { return mOffsets[i]; }
+	int end(std::size_t i) const { return mOffsets[i + 1]; }
+	int neighbor(int k) const { return mNeighbors[k]; }
+	std::size_t numPairs() const { return mNeighbors.size() / 2; }
+
+private:
+	template <typename Position>
+	bool moved(std::size_t count, Position position) const
+	{
+		auto limit = 0.25f * mSkin * mSkin;
+		std::atomic<bool> moved{false};
+		parallelRanges(count, [&](int, std::size_t first, std::size_t last) {
+			for (auto i = first; i < last && !moved.load(std::memory_order_relaxed); ++i)
+			{
+				if (position(i).squareDistance(mReference[i]) > limit)
+				{
+					moved.store(true, std::memory_order_relaxed);
+				}
+			}
+		});
+		return moved.load();
+	}
+
+	template <typename Position>
+	void build(std::size_t count, float radius, float skin, Position position)
+	{
+		mRadius = radius;
+		mSkin = skin;
+		mReference.resize(count);
+		parallelFor(count, [&](std::size_t i) { mReference[i] = position(i); });
+
+		// Counts, then an exclusive scan, then the fill; two queries per point are cheaper than merging
+		// per-thread lists, and rebuilds are rare.
+		auto cutoff = radius + skin;
+		mGrid.build(count, 2 * cutoff, [&](std::size_t i) { return mReference[i]; });
+		auto forEachCandidate = [&](std::size_t i, auto function) {
+			mGrid.forEachNeighbor(mReference[i], [&](int j, const ofVec3f &point) {
+				if (j != static_cast<int>(i) && mReference[i].squareDistance(point) < cutoff * cutoff)
+				{
+					function(j);
+				}
+			});
+		};
+		mOffsets.assign(count + 1, 0);
+		parallelFor(count, [&](std::size_t i) { forEachCandidate(i, [&](int) { ++mOffsets[i + 1]; }); });
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			mOffsets[i + 1] += mOffsets[i];
+		}
+		mNeighbors.resize(mOffsets[count]);
+		parallelFor(count, [&](std::size_t i) {
+			auto k = mOffsets[i];
+			forEachCandidate(i, [&](int j) { mNeighbors[k++] = j; });
+		});
+		mValid = true;
+	}
+
+	UniformGrid mGrid;
+	std::vector<ofVec3f> mReference;
+	std::vector<int> mOffsets;
+	std::vector<int> mNeighbors;
+	float mRadius = 0.0f;
+	float mSkin = 0.0f;
+	bool mValid = false;
+};
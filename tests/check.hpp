@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+// Minimal assertions for the test executables: a failed CHECK prints its location and carries on, and
+// main returns checkResult(), which is non-zero after any failure.
+inline int &checkFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			++checkFailures(); \
+		} \
+	} while (false)
+
+inline int checkResult()
+{
+	if (checkFailures() > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", checkFailures());
+		return 1;
+	}
+	return 0;
+}
+
+// A path in the system temporary directory, unique to this process.
+inline std::string temporaryPath(const std::string &name)
+{
+	return (std::filesystem::temp_directory_path() / ("random_graph_test_" + std::to_string(::getpid()) + "_" + name)).string();
+}
@@ -0,0 +1,101 @@
+#include "barnes_hut.hpp"
+#include "check.hpp"
+#include <random>
+
+namespace
+{
+ofVec3f exactRepulsion(const std::vector<ofVec3f> &positions, const std::vector<float> &masses, int self, float strength)
+{
+	ofVec3f force;
+	for (std::size_t j = 0; j < positions.size(); ++j)
+	{
+		if (static_cast<int>(j) != self)
+		{
+			auto delta = positions[self] - positions[j];
+			force += delta * (strength * masses[self] * masses[j] / std::max(delta.lengthSquared(), 1e-6f));
+		}
+	}
+	return force;
+}
+
+// Clustered points with uneven masses and a few exact duplicates, which end up in a leaf at kMaxDepth.
+void randomPoints(std::vector<ofVec3f> &positions, std::vector<float> &masses)
+{
+	std::mt19937 engine(8);
+	std::normal_distribution<float> normal(0.0f, 1.0f);
+	std::uniform_real_distribution<float> mass(0.5f, 4.0f);
+	positions.clear();
+	masses.clear();
+	for (auto i = 0; i < 3000; ++i)
+	{
+		auto cluster = static_cast<float>(i % 5) * 20.0f;
+		positions.emplace_back(cluster + normal(engine), normal(engine) * (1 + i % 3), normal(engine));
+		masses.push_back(mass(engine));
+	}
+	for (auto i = 0; i < 20; ++i)
+	{
+		positions.push_back(positions[7]);
+		masses.push_back(1.0f);
+	}
+}
+}
+
+// At theta = 0 no cell is ever approximated, so the tree sums every pair exactly, up to float rounding.
+void testExactAtThetaZero()
+{
+	std::vector<ofVec3f> positions;
+	std::vector<float> masses;
+	randomPoints(positions, masses);
+	BarnesHutTree tree;
+	tree.build(positions, masses);
+	auto worst = 0.0f;
+	for (std::size_t i = 0; i < positions.size(); i += 7)
+	{
+		auto expected = exactRepulsion(positions, masses, static_cast<int>(i), 2.0f);
+		auto force = tree.repulsion(positions[i], masses[i], static_cast<int>(i), 2.0f, 0.0f);
+		worst = std::max(worst, force.distance(expected) / std::max(expected.length(), 1e-3f));
+	}
+	CHECK(worst < 1e-4f);
+}
+
+// The usual theta keeps the relative error of the total force small on every point.
+void testApproximation()
+{
+	std::vector<ofVec3f> positions;
+	std::vector<float> masses;
+	randomPoints(positions, masses);
+	BarnesHutTree tree;
+	tree.build(positions, masses);
+	double error = 0;
+	double total = 0;
+	for (std::size_t i = 0; i < positions.size(); i += 7)
+	{
+		auto expected = exactRepulsion(positions, masses, static_cast<int>(i), 1.0f);
+		error += tree.repulsion(positions[i], masses[i], static_cast<int>(i), 1.0f, 0.5f).distance(expected);
+		total += expected.length();
+	}
+	CHECK(error < 0.02 * total);
+}
+
+void testEmptyAndSingle()
+{
+	BarnesHutTree tree;
+	std::vector<ofVec3f> positions;
+	std::vector<float> masses;
+	tree.build(positions, masses);
+	CHECK(tree.repulsion(ofVec3f(1, 2, 3), 1.0f, -1, 1.0f, 1.0f) == ofVec3f());
+
+	positions = {ofVec3f(1, 0, 0)};
+	masses = {2.0f};
+	tree.build(positions, masses);
+	CHECK(tree.repulsion(positions[0], 2.0f, 0, 1.0f, 1.0f) == ofVec3f());
+	CHECK(tree.repulsion(ofVec3f(3, 0, 0), 1.0f, -1, 1.0f, 1.0f).distance(ofVec3f(1, 0, 0)) < 1e-6f);
+}
+
+int main()
+{
+	testExactAtThetaZero();
+	testApproximation();
+	testEmptyAndSingle();
+	return checkResult();
+}
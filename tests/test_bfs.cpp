@@ -0,0 +1,113 @@
+#include "bfs.hpp"
+#include "check.hpp"
+#include "graph_generator.hpp"
+#include <queue>
+
+namespace
+{
+std::vector<int> sequentialBfs(const CsrGraph &graph, int source)
+{
+	std::vector<int> distances(graph.numNodes(), -1);
+	std::queue<int> queue;
+	distances[source] = 0;
+	queue.push(source);
+	while (!queue.empty())
+	{
+		auto u = queue.front();
+		queue.pop();
+		for (auto v = graph.begin(u); v != graph.end(u); ++v)
+		{
+			if (distances[*v] < 0)
+			{
+				distances[*v] = distances[u] + 1;
+				queue.push(*v);
+			}
+		}
+	}
+	return distances;
+}
+
+template <typename Generate>
+CsrGraph generate(int numNodes, unsigned seed, Generate streamEdges)
+{
+	std::mt19937 engine(seed);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(numNodes);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamEdges(context, nodes, stream);
+	return CsrGraph(numNodes, edges);
+}
+
+std::vector<CsrGraph> graphs()
+{
+	std::vector<CsrGraph> graphs;
+	for (unsigned seed = 1; seed <= 3; ++seed)
+	{
+		// Sparse enough to leave several components, and dense enough to switch to bottom-up.
+		graphs.push_back(generate(3000, seed, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamErdosRenyi(context, nodes, 0.0006f, stream); }));
+		graphs.push_back(generate(3000, seed, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamErdosRenyi(context, nodes, 0.01f, stream); }));
+		graphs.push_back(generate(3000, seed, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamBarabasiAlbert(context, nodes, 3, stream); }));
+	}
+	return graphs;
+}
+}
+
+// Every combination of switching thresholds, including always and never bottom-up, gives exact distances.
+void testDirectionOptimisingBfs()
+{
+	for (const auto &graph : graphs())
+	{
+		for (auto source : {0, 17, graph.numNodes() - 1})
+		{
+			auto expected = sequentialBfs(graph, source);
+			CHECK(breadthFirstSearch(graph, source) == expected);
+			CHECK(breadthFirstSearch(graph, source, 1, 1) == expected);
+			CHECK(breadthFirstSearch(graph, source, 1 << 30, 1 << 30) == expected);
+		}
+	}
+}
+
+void testMultiSourceBfs()
+{
+	for (const auto &graph : graphs())
+	{
+		std::vector<int> sources;
+		for (auto s = 0; s < 64; ++s)
+		{
+			sources.push_back(s * 41 % graph.numNodes());
+		}
+		for (auto numSources : {1, 5, 64})
+		{
+			auto result = multiSourceBfs(graph, sources.data(), numSources);
+			CHECK(result.mNumSources == numSources);
+			for (auto s = 0; s < numSources; ++s)
+			{
+				auto distances = sequentialBfs(graph, sources[s]);
+				double sum = 0;
+				std::int64_t reached = 0;
+				auto eccentricity = 0;
+				for (auto distance : distances)
+				{
+					if (distance > 0)
+					{
+						sum += distance;
+						++reached;
+						eccentricity = std::max(eccentricity, distance);
+					}
+				}
+				CHECK(result.mDistanceSums[s] == sum);
+				CHECK(result.mNumReached[s] == reached);
+				CHECK(result.mEccentricities[s] == eccentricity);
+			}
+		}
+	}
+}
+
+int main()
+{
+	testDirectionOptimisingBfs();
+	testMultiSourceBfs();
+	return checkResult();
+}
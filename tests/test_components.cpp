@@ -0,0 +1,124 @@
+#include "check.hpp"
+#include "csr_graph.hpp"
+#include "graph_generator.hpp"
+#include "union_find.hpp"
+#include <queue>
+
+namespace
+{
+std::vector<Edge> generate(int numNodes, unsigned seed, float edgeProb)
+{
+	std::mt19937 engine(seed);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(numNodes);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamErdosRenyi(context, nodes, edgeProb, stream);
+	return edges;
+}
+
+// Labels from a sequential BFS started at every unlabelled node in index order, so components are
+// numbered by their smallest node as connectedComponents promises.
+std::vector<int> sequentialComponents(int numNodes, const std::vector<Edge> &edges)
+{
+	CsrGraph graph(numNodes, edges);
+	std::vector<int> labels(numNodes, -1);
+	auto numComponents = 0;
+	for (auto source = 0; source < numNodes; ++source)
+	{
+		if (labels[source] >= 0)
+		{
+			continue;
+		}
+		std::queue<int> queue;
+		labels[source] = numComponents;
+		queue.push(source);
+		while (!queue.empty())
+		{
+			auto u = queue.front();
+			queue.pop();
+			for (auto v = graph.begin(u); v != graph.end(u); ++v)
+			{
+				if (labels[*v] < 0)
+				{
+					labels[*v] = numComponents;
+					queue.push(*v);
+				}
+			}
+		}
+		++numComponents;
+	}
+	return labels;
+}
+}
+
+// From many small components through the giant-component transition to a single component; self-loops
+// and repeated edges must not matter.
+void testAgainstBfs()
+{
+	const auto numNodes = 5000;
+	for (auto meanDegree : {0.5f, 1.0f, 2.0f, 8.0f})
+	{
+		auto edges = generate(numNodes, 21, meanDegree / numNodes);
+		edges.push_back(Edge{7, 7, 1.0f, 0.0f});
+		if (!edges.empty())
+		{
+			edges.push_back(edges.front());
+		}
+		auto components = connectedComponents(numNodes, edges);
+		auto expected = sequentialComponents(numNodes, edges);
+		CHECK(components.mLabels == expected);
+		CHECK(components.mNumComponents == *std::max_element(expected.begin(), expected.end()) + 1);
+
+		std::vector<int> sizes(components.mNumComponents, 0);
+		for (auto label : expected)
+		{
+			++sizes[label];
+		}
+		auto giant = std::max_element(sizes.begin(), sizes.end());
+		CHECK(components.mGiantLabel == giant - sizes.begin());
+		CHECK(components.mGiantSize == *giant);
+	}
+
+	auto empty = connectedComponents(0, {});
+	CHECK(empty.mNumComponents == 0 && empty.mGiantLabel == -1 && empty.mGiantSize == 0);
+}
+
+// Unions from many threads at once, whatever the core count: every root ends up as the smallest node
+// of its component.
+void testConcurrentUnions()
+{
+	const auto numNodes = 20000;
+	auto edges = generate(numNodes, 22, 1.2f / numNodes);
+	auto expected = sequentialComponents(numNodes, edges);
+	std::vector<int> smallest(numNodes, numNodes);
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		smallest[expected[i]] = std::min(smallest[expected[i]], i);
+	}
+
+	for (auto threads : {2, 8, 32})
+	{
+		ConcurrentUnionFind unionFind(numNodes);
+		parallelRanges(edges.size(), [&](int, std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i)
+			{
+				unionFind.unite(edges[i].mHead, edges[i].mTail);
+			}
+		}, threads);
+		auto mismatches = 0;
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			mismatches += unionFind.find(i) != smallest[expected[i]];
+		}
+		CHECK(mismatches == 0);
+	}
+}
+
+int main()
+{
+	testAgainstBfs();
+	testConcurrentUnions();
+	return checkResult();
+}
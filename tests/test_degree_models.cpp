@@ -0,0 +1,123 @@
+#include "check.hpp"
+#include "graph_generator.hpp"
+#include <numeric>
+
+namespace
+{
+template <typename Generate>
+std::vector<Edge> generate(int numNodes, unsigned seed, Generate streamEdges)
+{
+	std::mt19937 engine(seed);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(numNodes);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamEdges(context, nodes, stream);
+	return edges;
+}
+
+bool isSimple(const std::vector<Edge> &edges)
+{
+	std::vector<std::uint64_t> keys;
+	for (const auto &edge : edges)
+	{
+		if (edge.mHead == edge.mTail)
+		{
+			return false;
+		}
+		keys.push_back(edgeKey(edge.mHead, edge.mTail));
+	}
+	std::sort(keys.begin(), keys.end());
+	return std::adjacent_find(keys.begin(), keys.end()) == keys.end();
+}
+}
+
+// Without erasure every node keeps its degree exactly, self-loops counting twice.
+void testConfigurationModel()
+{
+	std::vector<int> degrees(5000);
+	for (std::size_t i = 0; i < degrees.size(); ++i)
+	{
+		degrees[i] = 1 + static_cast<int>(i % 7) * (i % 97 == 0 ? 30 : 1);
+	}
+	if (std::accumulate(degrees.begin(), degrees.end(), 0) % 2 != 0)
+	{
+		++degrees[0];
+	}
+	auto edges = generate(degrees.size(), 11, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamConfigurationModel(context, nodes, degrees, false, stream); });
+	CHECK(degreeSequence(degrees.size(), edges) == degrees);
+
+	// An odd total drops a single stub.
+	++degrees[1];
+	edges = generate(degrees.size(), 12, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamConfigurationModel(context, nodes, degrees, false, stream); });
+	auto actual = degreeSequence(degrees.size(), edges);
+	auto difference = 0;
+	for (std::size_t i = 0; i < degrees.size(); ++i)
+	{
+		CHECK(actual[i] <= degrees[i]);
+		difference += degrees[i] - actual[i];
+	}
+	CHECK(difference == 1);
+}
+
+// The erased model is simple and only trims degrees, by little on a sparse sequence.
+void testErasedConfigurationModel()
+{
+	std::vector<int> degrees(5000, 4);
+	auto edges = generate(degrees.size(), 13, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamConfigurationModel(context, nodes, degrees, true, stream); });
+	CHECK(isSimple(edges));
+	auto actual = degreeSequence(degrees.size(), edges);
+	for (std::size_t i = 0; i < degrees.size(); ++i)
+	{
+		CHECK(actual[i] <= degrees[i]);
+	}
+	CHECK(edges.size() > 0.99 * degrees.size() * 4 / 2);
+}
+
+// Mean degrees follow the weights, and the graph is simple.
+void testChungLu()
+{
+	const auto numNodes = 20000;
+	std::vector<float> weights(numNodes);
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		weights[i] = i % 2 == 0 ? 4.0f : 20.0f;
+	}
+	auto edges = generate(numNodes, 14, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamChungLu(context, nodes, weights, stream); });
+	CHECK(isSimple(edges));
+
+	auto degrees = degreeSequence(numNodes, edges);
+	double sums[2] = {0, 0};
+	for (auto i = 0; i < numNodes; ++i)
+	{
+		sums[i % 2] += degrees[i];
+	}
+	auto meanLow = sums[0] / (numNodes / 2);
+	auto meanHigh = sums[1] / (numNodes / 2);
+	CHECK(std::abs(meanLow - 4) < 0.1);
+	CHECK(std::abs(meanHigh - 20) < 0.3);
+}
+
+void testTooFewNodes()
+{
+	auto threw = false;
+	try
+	{
+		generate(3, 15, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamConfigurationModel(context, nodes, std::vector<int>(4, 1), false, stream); });
+	}
+	catch (const std::runtime_error &)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+}
+
+int main()
+{
+	testConfigurationModel();
+	testErasedConfigurationModel();
+	testChungLu();
+	testTooFewNodes();
+	return checkResult();
+}
@@ -0,0 +1,99 @@
+#include "check.hpp"
+#include "dirty_ranges.hpp"
+#include <random>
+
+namespace
+{
+std::vector<std::pair<std::size_t, std::size_t>> rangesOf(DirtyRanges &dirty)
+{
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+	for (const auto &range : dirty.ranges())
+	{
+		ranges.emplace_back(range.mFirst, range.mLast);
+	}
+	return ranges;
+}
+}
+
+void testIncreasingMarks()
+{
+	DirtyRanges dirty(2);
+	CHECK(dirty.empty());
+	dirty.mark(3);
+	dirty.mark(4);
+	dirty.mark(7);
+	dirty.mark(20, 25);
+	dirty.mark(22, 23);
+	dirty.mark(30, 30);
+	CHECK((rangesOf(dirty) == std::vector<std::pair<std::size_t, std::size_t>>{{3, 8}, {20, 25}}));
+	dirty.clear();
+	CHECK(dirty.empty());
+	CHECK(rangesOf(dirty).empty());
+}
+
+void testUnorderedMarks()
+{
+	DirtyRanges dirty(0);
+	dirty.mark(50, 60);
+	dirty.mark(10, 20);
+	dirty.mark(55, 70);
+	dirty.mark(20, 30);
+	dirty.mark(0, 5);
+	CHECK((rangesOf(dirty) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 5}, {10, 30}, {50, 70}}));
+	// Reading again, or marking in order afterwards, keeps the merged form.
+	CHECK((rangesOf(dirty) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 5}, {10, 30}, {50, 70}}));
+	dirty.mark(70, 72);
+	CHECK((rangesOf(dirty) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 5}, {10, 30}, {50, 72}}));
+}
+
+// Random marks in any order: every marked index is covered, ranges are sorted and separated by more
+// than the merge gap, and no range starts or ends on a clean index.
+void testRandomMarks()
+{
+	std::mt19937 engine(41);
+	for (auto trial = 0; trial < 200; ++trial)
+	{
+		const std::size_t size = 500;
+		const std::size_t gap = engine() % 8;
+		DirtyRanges dirty(gap);
+		std::vector<bool> marked(size, false);
+		for (auto mark = 0; mark < 20; ++mark)
+		{
+			auto first = engine() % size;
+			auto last = std::min(size, first + engine() % 12);
+			dirty.mark(first, last);
+			for (auto i = first; i < last; ++i)
+			{
+				marked[i] = true;
+			}
+		}
+
+		const auto &ranges = dirty.ranges();
+		std::vector<bool> covered(size, false);
+		for (std::size_t r = 0; r < ranges.size(); ++r)
+		{
+			CHECK(ranges[r].mFirst < ranges[r].mLast);
+			CHECK(marked[ranges[r].mFirst] && marked[ranges[r].mLast - 1]);
+			if (r > 0)
+			{
+				CHECK(ranges[r].mFirst > ranges[r - 1].mLast + gap);
+			}
+			for (auto i = ranges[r].mFirst; i < ranges[r].mLast; ++i)
+			{
+				covered[i] = true;
+			}
+		}
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			CHECK(!marked[i] || covered[i]);
+		}
+	}
+}
+
+int main()
+{
+	testIncreasingMarks();
+	testUnorderedMarks();
+	testRandomMarks();
+	return checkResult();
+}
@@ -0,0 +1,162 @@
+#include "check.hpp"
+#include "dynamic_graph.hpp"
+#include "graph_generator.hpp"
+#include <map>
+#include <random>
+
+namespace
+{
+using PairCounts = std::map<std::pair<int, int>, int>;
+
+std::pair<int, int> pairOf(int u, int v)
+{
+	return std::make_pair(std::min(u, v), std::max(u, v));
+}
+
+// Ids, positions, both adjacency entries of every edge and the pair index all agree with the edge
+// vector, and with an independent count of the pairs.
+void checkInvariants(const DynamicGraph &graph, const std::vector<Edge> &edges, const PairCounts &counts)
+{
+	CHECK(graph.numEdges() == edges.size());
+	for (std::size_t position = 0; position < edges.size(); ++position)
+	{
+		auto id = graph.id(position);
+		CHECK(graph.position(id) == position);
+		CHECK(&graph.edge(id) == &edges[position]);
+	}
+
+	std::size_t numEntries = 0;
+	for (auto u = 0; u < graph.numNodes(); ++u)
+	{
+		numEntries += graph.neighbors(u).size();
+		for (const auto &incidence : graph.neighbors(u))
+		{
+			const auto &edge = graph.edge(incidence.mEdge);
+			CHECK((edge.mHead == u && edge.mTail == incidence.mNeighbor) || (edge.mTail == u && edge.mHead == incidence.mNeighbor));
+		}
+	}
+	CHECK(numEntries == 2 * edges.size());
+	CHECK(degreeSequence(graph.numNodes(), edges) == [&] {
+		std::vector<int> degrees(graph.numNodes());
+		for (auto u = 0; u < graph.numNodes(); ++u)
+		{
+			degrees[u] = graph.degree(u);
+		}
+		return degrees;
+	}());
+
+	// Each edge's own two entries point back at it; a self-loop has two entries on its node.
+	for (std::size_t position = 0; position < edges.size(); ++position)
+	{
+		auto id = graph.id(position);
+		auto entries = 0;
+		for (auto node : {edges[position].mHead, edges[position].mTail})
+		{
+			for (const auto &incidence : graph.neighbors(node))
+			{
+				entries += incidence.mEdge == id;
+			}
+		}
+		CHECK(entries == (edges[position].mHead == edges[position].mTail ? 4 : 2));
+	}
+
+	for (const auto &count : counts)
+	{
+		auto u = count.first.first;
+		auto v = count.first.second;
+		CHECK(graph.contains(u, v) == (count.second > 0));
+		CHECK(graph.contains(v, u) == (count.second > 0));
+		auto id = graph.find(v, u);
+		CHECK((id == kInvalidEdge) == (count.second == 0));
+		if (id != kInvalidEdge)
+		{
+			CHECK(pairOf(graph.edge(id).mHead, graph.edge(id).mTail) == count.first);
+		}
+	}
+}
+}
+
+// Random inserts and removals on a small node set, so that self-loops and parallel edges are common.
+void testRandomOperations()
+{
+	std::mt19937 engine(31);
+	std::vector<Edge> edges;
+	DynamicGraph graph;
+	graph.assign(edges, 6);
+	PairCounts counts;
+
+	for (auto step = 0; step < 3000; ++step)
+	{
+		if (step % 500 == 0)
+		{
+			graph.addNode();
+		}
+		auto numNodes = graph.numNodes();
+		if (edges.empty() || engine() % 5 < 3)
+		{
+			auto u = static_cast<int>(engine() % numNodes);
+			auto v = engine() % 4 == 0 ? u : static_cast<int>(engine() % numNodes);
+			auto id = graph.addEdge(Edge{u, v, 1.0f, static_cast<float>(step)});
+			CHECK(graph.edge(id).mWeight == static_cast<float>(step));
+			++counts[pairOf(u, v)];
+		}
+		else
+		{
+			auto position = engine() % edges.size();
+			auto edge = edges[position];
+			graph.removeEdge(graph.id(position));
+			--counts[pairOf(edge.mHead, edge.mTail)];
+		}
+		if (step % 100 == 0)
+		{
+			checkInvariants(graph, edges, counts);
+		}
+	}
+	checkInvariants(graph, edges, counts);
+
+	while (!edges.empty())
+	{
+		auto edge = edges.back();
+		graph.removeEdge(graph.id(edges.size() - 1));
+		--counts[pairOf(edge.mHead, edge.mTail)];
+	}
+	checkInvariants(graph, edges, counts);
+}
+
+// Ids stay attached to their edges while other edges move through swap-and-pop.
+void testStableIds()
+{
+	std::vector<Edge> edges = {{0, 1, 1.0f, 0.0f}, {1, 2, 1.0f, 1.0f}, {2, 2, 1.0f, 2.0f}, {1, 0, 1.0f, 3.0f}};
+	DynamicGraph graph;
+	graph.assign(edges, 3);
+	PairCounts counts = {{{0, 1}, 2}, {{1, 2}, 1}, {{2, 2}, 1}};
+	checkInvariants(graph, edges, counts);
+
+	std::vector<EdgeId> ids;
+	for (std::size_t position = 0; position < edges.size(); ++position)
+	{
+		ids.push_back(graph.id(position));
+	}
+	graph.removeEdge(ids[0]);
+	--counts[{0, 1}];
+	CHECK(graph.edge(ids[3]).mWeight == 3.0f);
+	CHECK(graph.find(0, 1) == ids[3]);
+	graph.removeEdge(ids[2]);
+	--counts[{2, 2}];
+	CHECK(graph.edge(ids[1]).mWeight == 1.0f);
+	CHECK(!graph.contains(2, 2));
+	checkInvariants(graph, edges, counts);
+
+	// Freed ids are reused.
+	auto id = graph.addEdge(Edge{2, 0, 1.0f, 4.0f});
+	++counts[{0, 2}];
+	CHECK(id == ids[0] || id == ids[2]);
+	checkInvariants(graph, edges, counts);
+}
+
+int main()
+{
+	testRandomOperations();
+	testStableIds();
+	return checkResult();
+}
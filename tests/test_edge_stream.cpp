@@ -0,0 +1,99 @@
+#include "check.hpp"
+#include "edge_sink.hpp"
+#include "graph_generator.hpp"
+#include <cmath>
+#include <cstdio>
+
+// Chunks reach the sink at exactly the chunk size, with the remainder on flush.
+void testChunking()
+{
+	std::vector<std::size_t> chunks;
+	std::vector<Edge> edges;
+	CallbackEdgeSink sink([&](const Edge *chunk, std::size_t count) {
+		chunks.push_back(count);
+		edges.insert(edges.end(), chunk, chunk + count);
+	});
+	EdgeStream stream(sink, 4);
+	for (auto i = 0; i < 10; ++i)
+	{
+		stream.emit(Edge{i, i + 1, 1.0f, 0.5f});
+	}
+	stream.flush();
+	stream.flush();
+	CHECK((chunks == std::vector<std::size_t>{4, 4, 2}));
+	CHECK(edges.size() == 10);
+	CHECK(edges[9].mHead == 9 && edges[9].mTail == 10);
+}
+
+// Skip sampling yields about p n (n - 1) / 2 distinct pairs j < i, the same for any chunk size.
+void testErdosRenyiEdgeCount()
+{
+	const auto numNodes = 2000;
+	const auto edgeProb = 0.01f;
+	std::vector<Node> nodes(numNodes);
+	GeneratorParams params;
+
+	std::vector<Edge> edges[2];
+	std::size_t chunkSizes[2] = {1, 65536};
+	for (auto run = 0; run < 2; ++run)
+	{
+		std::mt19937 engine(7);
+		GeneratorContext context(engine, params);
+		VectorEdgeSink sink(edges[run]);
+		EdgeStream stream(sink, chunkSizes[run]);
+		streamErdosRenyi(context, nodes, edgeProb, stream);
+	}
+	CHECK(edges[0].size() == edges[1].size());
+
+	auto expected = edgeProb * numNodes * (numNodes - 1) / 2.0;
+	CHECK(std::abs(edges[1].size() - expected) < 5 * std::sqrt(expected));
+	std::vector<std::uint64_t> keys;
+	for (const auto &edge : edges[1])
+	{
+		CHECK(edge.mTail < edge.mHead && edge.mHead < numNodes && edge.mTail >= 0);
+		keys.push_back(edgeKey(edge.mHead, edge.mTail));
+	}
+	std::sort(keys.begin(), keys.end());
+	CHECK(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+}
+
+void testFileEdgeSink()
+{
+	auto path = temporaryPath("edges.bin");
+	std::vector<Edge> edges = {{0, 1, 2.0f, 0.25f}, {3, 2, 1.5f, 0.75f}};
+	{
+		FileEdgeSink sink(path, 16);
+		sink.consume(edges.data(), edges.size());
+		sink.close();
+		CHECK(sink.numEdges() == 2);
+		auto threw = false;
+		try
+		{
+			sink.consume(edges.data(), 1);
+		}
+		catch (const std::runtime_error &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	}
+
+	std::vector<Edge> read(3);
+	auto file = std::fopen(path.c_str(), "rb");
+	CHECK(file != nullptr);
+	if (file)
+	{
+		CHECK(std::fread(read.data(), sizeof(Edge), read.size(), file) == 2);
+		std::fclose(file);
+		CHECK(read[1].mHead == 3 && read[1].mTail == 2 && read[1].mLength == 1.5f && read[1].mWeight == 0.75f);
+	}
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	testChunking();
+	testErdosRenyiEdgeCount();
+	testFileEdgeSink();
+	return checkResult();
+}
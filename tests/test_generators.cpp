@@ -0,0 +1,206 @@
+#include "check.hpp"
+#include "graph_generator.hpp"
+#include <cmath>
+
+namespace
+{
+template <typename Generate>
+std::vector<Edge> generate(int numNodes, unsigned seed, Generate streamEdges)
+{
+	std::mt19937 engine(seed);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(numNodes);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamEdges(context, nodes, stream);
+	return edges;
+}
+
+bool isSimple(const std::vector<Edge> &edges)
+{
+	std::vector<std::uint64_t> keys;
+	for (const auto &edge : edges)
+	{
+		if (edge.mHead == edge.mTail)
+		{
+			return false;
+		}
+		keys.push_back(edgeKey(edge.mHead, edge.mTail));
+	}
+	std::sort(keys.begin(), keys.end());
+	return std::adjacent_find(keys.begin(), keys.end()) == keys.end();
+}
+}
+
+// Before rewiring the ring lattice gives every node degree 2 (k / 2), joining i to i + 1 .. i + k / 2.
+void testWattsStrogatzLattice()
+{
+	const auto numNodes = 1000;
+	for (auto numNeighbors : {2, 6, 7})
+	{
+		auto edges = generate(numNodes, 3, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamWattsStrogatzRing(context, nodes, numNeighbors, 0.0f, stream); });
+		CHECK(edges.size() == static_cast<std::size_t>(numNodes * (numNeighbors / 2)));
+		CHECK(degreeSequence(numNodes, edges) == std::vector<int>(numNodes, 2 * (numNeighbors / 2)));
+		for (const auto &edge : edges)
+		{
+			auto offset = (edge.mTail - edge.mHead + numNodes) % numNodes;
+			CHECK(offset >= 1 && offset <= numNeighbors / 2);
+		}
+	}
+}
+
+// The spatial lattice joins each node to its k nearest others, never to itself, even when every node
+// sits at the same point; rewiring keeps one edge per (node, neighbour) slot and adds no loops.
+void testWattsStrogatzSpatial()
+{
+	const auto numNodes = 300;
+	const auto numNeighbors = 4;
+	for (auto rewireProb : {0.0f, 0.5f, 1.0f})
+	{
+		for (auto spread : {0.0f, 1.0f})
+		{
+			std::mt19937 engine(6);
+			GeneratorContext context(engine, GeneratorParams());
+			std::vector<Node> nodes(numNodes);
+			for (auto i = 0; i < numNodes; ++i)
+			{
+				nodes[i].mPosition = ofVec3f(spread * i, 0, 0);
+			}
+			std::vector<Edge> edges;
+			VectorEdgeSink sink(edges);
+			EdgeStream stream(sink, 4096);
+			streamWattsStrogatz(context, nodes, numNeighbors, rewireProb, stream);
+			CHECK(edges.size() == static_cast<std::size_t>(numNodes * numNeighbors));
+			auto loops = 0;
+			auto nearest = true;
+			for (const auto &edge : edges)
+			{
+				loops += edge.mHead == edge.mTail;
+				nearest = nearest && std::abs(edge.mHead - edge.mTail) <= numNeighbors;
+			}
+			CHECK(loops == 0);
+			if (rewireProb == 0.0f && spread > 0.0f)
+			{
+				CHECK(nearest);
+			}
+		}
+	}
+	auto single = generate(1, 6, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamWattsStrogatz(context, nodes, 4, 1.0f, stream); });
+	CHECK(single.empty());
+}
+
+// Rewiring moves edges without creating loops or repeats, so the edge count is kept; every node keeps
+// at least the k / 2 edges it owns.
+void testWattsStrogatzRewiring()
+{
+	const auto numNodes = 2000;
+	const auto numNeighbors = 10;
+	for (auto rewireProb : {0.1f, 1.0f})
+	{
+		auto edges = generate(numNodes, 4, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamWattsStrogatzRing(context, nodes, numNeighbors, rewireProb, stream); });
+		CHECK(edges.size() == static_cast<std::size_t>(numNodes * numNeighbors / 2));
+		CHECK(isSimple(edges));
+		auto rewired = 0;
+		for (const auto &edge : edges)
+		{
+			auto offset = (edge.mTail - edge.mHead + numNodes) % numNodes;
+			rewired += offset < 1 || offset > numNeighbors / 2;
+		}
+		auto expected = rewireProb * edges.size();
+		CHECK(std::abs(rewired - expected) < 0.1 * edges.size());
+		for (auto degree : degreeSequence(numNodes, edges))
+		{
+			CHECK(degree >= numNeighbors / 2);
+		}
+	}
+}
+
+// Deduplication leaves a simple graph with as many edges as the raw multigraph has distinct non-loop
+// pairs, up to sampling noise; the raw mode also draws weights, so the two do not share draws. n is
+// not a power of two, so some draws land outside [0, n) and are redrawn.
+void testRmatDedupe()
+{
+	const auto numNodes = 3000;
+	RmatParams params;
+	params.mEdgeFactor = 8;
+	params.mDedupe = false;
+	auto raw = generate(numNodes, 5, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamRmat(context, nodes, params, stream); });
+	params.mDedupe = true;
+	auto edges = generate(numNodes, 5, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamRmat(context, nodes, params, stream); });
+
+	CHECK(raw.size() == static_cast<std::size_t>(numNodes * params.mEdgeFactor));
+	CHECK(!isSimple(raw));
+	CHECK(isSimple(edges));
+
+	std::vector<std::uint64_t> expected;
+	for (const auto &edge : raw)
+	{
+		CHECK(edge.mHead >= 0 && edge.mHead < numNodes && edge.mTail >= 0 && edge.mTail < numNodes);
+		if (edge.mHead != edge.mTail)
+		{
+			expected.push_back(edgeKey(edge.mHead, edge.mTail));
+		}
+	}
+	std::sort(expected.begin(), expected.end());
+	expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+	CHECK(edges.size() < raw.size());
+	CHECK(std::abs(static_cast<double>(edges.size()) - expected.size()) < 0.02 * expected.size());
+	for (const auto &edge : edges)
+	{
+		CHECK(edge.mHead >= 0 && edge.mHead < numNodes && edge.mTail >= 0 && edge.mTail < numNodes);
+	}
+
+	// The skewed quadrants give hubs far above the mean degree.
+	auto degrees = degreeSequence(numNodes, edges);
+	CHECK(*std::max_element(degrees.begin(), degrees.end()) > 10.0 * 2 * edges.size() / numNodes);
+}
+
+// Edge counts per block pair follow p_rs times the number of node pairs, within five standard
+// deviations; p = 0 and p = 1 are exact, and the lower triangle of the matrix is never read.
+void testStochasticBlockModel()
+{
+	SbmParams params;
+	params.mBlockSizes = {300, 500, 200};
+	params.mProbabilities = {0.3f, 0.02f, 0.0f,
+							 0.9f, 0.1f, 1.0f,
+							 0.9f, 0.9f, 0.05f};
+	std::vector<int> block;
+	for (auto b = 0; b < 3; ++b)
+	{
+		block.insert(block.end(), params.mBlockSizes[b], b);
+	}
+	auto edges = generate(block.size(), 6, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamStochasticBlockModel(context, nodes, params, stream); });
+	CHECK(isSimple(edges));
+
+	std::vector<double> counts(9, 0.0);
+	for (const auto &edge : edges)
+	{
+		auto r = std::min(block[edge.mHead], block[edge.mTail]);
+		auto s = std::max(block[edge.mHead], block[edge.mTail]);
+		++counts[r * 3 + s];
+	}
+	for (auto r = 0; r < 3; ++r)
+	{
+		for (auto s = r; s < 3; ++s)
+		{
+			double rows = params.mBlockSizes[r];
+			auto pairs = r == s ? rows * (rows - 1) / 2 : rows * params.mBlockSizes[s];
+			auto edgeProb = params.mProbabilities[r * 3 + s];
+			auto expected = edgeProb * pairs;
+			CHECK(std::abs(counts[r * 3 + s] - expected) <= 5 * std::sqrt(pairs * edgeProb * (1 - edgeProb)));
+		}
+	}
+	CHECK(counts[0 * 3 + 2] == 0);
+	CHECK(counts[1 * 3 + 2] == 500 * 200);
+}
+
+int main()
+{
+	testWattsStrogatzLattice();
+	testWattsStrogatzRewiring();
+	testWattsStrogatzSpatial();
+	testRmatDedupe();
+	testStochasticBlockModel();
+	return checkResult();
+}
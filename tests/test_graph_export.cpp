@@ -0,0 +1,88 @@
+#include "check.hpp"
+#include "graph_export.hpp"
+#include "graph_import.hpp"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+// Random endpoints and weights spanning several orders of magnitude; the last node stays isolated.
+void randomGraph(std::vector<Node> &nodes, std::vector<Edge> &edges)
+{
+	std::mt19937 engine(5);
+	std::uniform_int_distribution<int> endpoint(0, 998);
+	std::uniform_real_distribution<float> exponent(-8.0f, 3.0f);
+	nodes.assign(1000, Node{ofVec3f(1.5f, -2.0f, 0.25f)});
+	edges.clear();
+	for (auto i = 0; i < 20000; ++i)
+	{
+		edges.push_back(Edge{endpoint(engine), endpoint(engine), 1.0f, std::pow(10.0f, exponent(engine))});
+	}
+	edges.push_back(Edge{3, 3, 1.0f, 0.0f});
+}
+
+bool sameEdges(const std::vector<Edge> &imported, const std::vector<Edge> &edges)
+{
+	if (imported.size() != edges.size())
+	{
+		return false;
+	}
+	for (std::size_t i = 0; i < edges.size(); ++i)
+	{
+		if (imported[i].mHead != edges[i].mHead || imported[i].mTail != edges[i].mTail || imported[i].mWeight != edges[i].mWeight)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+// Shortest round-trip formatting brings every weight back bit for bit, in the original edge order.
+void testEdgeListRoundTrip()
+{
+	std::vector<Node> nodes;
+	std::vector<Edge> edges;
+	randomGraph(nodes, edges);
+	auto path = temporaryPath("export.txt");
+	exportGraph(path, nodes, edges);
+	for (auto threads : {1, 4})
+	{
+		auto graph = importEdgeList(path, threads);
+		CHECK(sameEdges(graph.mEdges, edges));
+		CHECK(graph.mNumNodes == 999);
+	}
+	std::remove(path.c_str());
+}
+
+// GraphML also keeps isolated nodes, because every node is written as its own element.
+void testGraphMLRoundTrip()
+{
+	std::vector<Node> nodes;
+	std::vector<Edge> edges;
+	randomGraph(nodes, edges);
+	auto path = temporaryPath("export.graphml");
+	exportGraph(path, nodes, edges);
+	auto graph = importGraphML(path);
+	CHECK(sameEdges(graph.mEdges, edges));
+	CHECK(graph.mNumNodes == static_cast<int>(nodes.size()));
+	std::remove(path.c_str());
+}
+
+void testEmptyGraph()
+{
+	auto path = temporaryPath("empty.graphml");
+	exportGraph(path, {}, {});
+	auto graph = importGraphML(path);
+	CHECK(graph.mNumNodes == 0 && graph.mEdges.empty());
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	testEdgeListRoundTrip();
+	testGraphMLRoundTrip();
+	testEmptyGraph();
+	return checkResult();
+}
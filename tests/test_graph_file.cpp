@@ -0,0 +1,158 @@
+#include "check.hpp"
+#include "graph_file.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+std::vector<Node> nodes = {Node{ofVec3f(1, 2, 3)}, Node{ofVec3f(-4, 5, 6)}, Node{ofVec3f(0, 0, 7)}, Node{ofVec3f(8, 9, -1)}};
+std::vector<Edge> edges = {{0, 1, 1.0f, 0.1f}, {1, 2, 2.0f, 0.2f}, {2, 0, 3.0f, 0.3f}, {3, 1, 4.0f, 0.4f}};
+
+bool throwsOnCsr(const std::string &path)
+{
+	try
+	{
+		MappedGraphFile(path).csr();
+	}
+	catch (const std::runtime_error &)
+	{
+		return true;
+	}
+	return false;
+}
+
+bool throwsOnOpen(const std::string &path)
+{
+	try
+	{
+		MappedGraphFile file(path);
+	}
+	catch (const std::runtime_error &)
+	{
+		return true;
+	}
+	return false;
+}
+
+std::vector<char> readFile(const std::string &path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::vector<char> &bytes)
+{
+	std::ofstream stream(path, std::ios::binary);
+	stream.write(bytes.data(), bytes.size());
+}
+}
+
+void testRoundTrip()
+{
+	auto path = temporaryPath("round_trip.rgraph");
+	CsrGraph csr(nodes.size(), edges);
+	writeGraphFile(path, nodes, edges, csr);
+
+	MappedGraphFile file(path);
+	CHECK(file.numNodes() == nodes.size());
+	CHECK(file.numEdges() == edges.size());
+	CHECK(file.numArcs() == csr.numArcs());
+	for (std::size_t i = 0; i < nodes.size(); ++i)
+	{
+		CHECK(file.positions()[i] == nodes[i].mPosition);
+	}
+	for (std::size_t i = 0; i <= nodes.size(); ++i)
+	{
+		CHECK(file.offsets()[i] == csr.mOffsets[i]);
+	}
+	CHECK(std::equal(csr.mNeighbors.begin(), csr.mNeighbors.end(), file.neighbors()));
+	auto loaded = file.csr();
+	CHECK(loaded.mOffsets == csr.mOffsets && loaded.mNeighbors == csr.mNeighbors);
+	for (std::size_t e = 0; e < edges.size(); ++e)
+	{
+		CHECK(file.heads()[e] == edges[e].mHead && file.tails()[e] == edges[e].mTail);
+		CHECK(file.lengths()[e] == edges[e].mLength && file.weights()[e] == edges[e].mWeight);
+	}
+	std::remove(path.c_str());
+}
+
+void testEmptyGraph()
+{
+	auto path = temporaryPath("empty.rgraph");
+	writeGraphFile(path, {}, {}, CsrGraph(0, std::vector<Edge>()));
+	MappedGraphFile file(path);
+	CHECK(file.numNodes() == 0 && file.numEdges() == 0 && file.numArcs() == 0);
+	std::remove(path.c_str());
+}
+
+// Truncation and out-of-range section offsets are rejected when the file is opened, not when read.
+void testCorruptFiles()
+{
+	auto path = temporaryPath("corrupt.rgraph");
+	writeGraphFile(path, nodes, edges, CsrGraph(nodes.size(), edges));
+	auto bytes = readFile(path);
+
+	auto truncated = bytes;
+	truncated.resize(bytes.size() - 4);
+	writeFile(path, truncated);
+	CHECK(throwsOnOpen(path));
+
+	auto shortHeader = bytes;
+	shortHeader.resize(sizeof(GraphFileHeader) - 1);
+	writeFile(path, shortHeader);
+	CHECK(throwsOnOpen(path));
+
+	GraphFileHeader header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	auto corrupt = [&](auto modify) {
+		auto copy = header;
+		modify(copy);
+		auto modified = bytes;
+		std::memcpy(modified.data(), &copy, sizeof(copy));
+		writeFile(path, modified);
+		return throwsOnOpen(path);
+	};
+	CHECK(corrupt([](GraphFileHeader &h) { h.mWeightsOffset = h.mFileSize; }));
+	CHECK(corrupt([](GraphFileHeader &h) { h.mHeadsOffset += 1; }));
+	CHECK(corrupt([](GraphFileHeader &h) { h.mNumArcs = UINT64_MAX / 4; }));
+	CHECK(corrupt([](GraphFileHeader &h) { h.mNumNodes = std::uint64_t(1) << 40; }));
+	CHECK(corrupt([](GraphFileHeader &h) { h.mVersion += 1; }));
+	CHECK(!corrupt([](GraphFileHeader &) {}));
+	std::remove(path.c_str());
+}
+
+// A header that passes the section checks can still carry an adjacency traversals cannot trust.
+void testCorruptCsr()
+{
+	auto path = temporaryPath("corrupt_csr.rgraph");
+	writeGraphFile(path, nodes, edges, CsrGraph(nodes.size(), edges));
+	auto bytes = readFile(path);
+	GraphFileHeader header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	auto corrupt = [&](auto modify) {
+		auto modified = bytes;
+		modify(reinterpret_cast<std::uint64_t *>(modified.data() + header.mOffsetsOffset),
+			   reinterpret_cast<std::int32_t *>(modified.data() + header.mNeighborsOffset));
+		writeFile(path, modified);
+		return throwsOnCsr(path);
+	};
+	CHECK(corrupt([](std::uint64_t *offsets, std::int32_t *) { offsets[0] = 1; }));
+	CHECK(corrupt([](std::uint64_t *offsets, std::int32_t *) { offsets[1] = offsets[4] + 100; }));
+	CHECK(corrupt([](std::uint64_t *offsets, std::int32_t *) { std::swap(offsets[1], offsets[2]); }));
+	CHECK(corrupt([](std::uint64_t *, std::int32_t *neighbors) { neighbors[0] = 4; }));
+	CHECK(corrupt([](std::uint64_t *, std::int32_t *neighbors) { neighbors[0] = -1; }));
+	CHECK(corrupt([](std::uint64_t *, std::int32_t *neighbors) { neighbors[0] = 0; }));
+	CHECK(corrupt([](std::uint64_t *, std::int32_t *neighbors) { std::swap(neighbors[0], neighbors[1]); }));
+	CHECK(!corrupt([](std::uint64_t *, std::int32_t *) {}));
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	testRoundTrip();
+	testEmptyGraph();
+	testCorruptFiles();
+	testCorruptCsr();
+	return checkResult();
+}
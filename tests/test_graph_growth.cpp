@@ -0,0 +1,67 @@
+#include "check.hpp"
+#include "force_atlas2.hpp"
+#include "graph_growth.hpp"
+#include <cmath>
+
+// Growth with rewiring and churn keeps the graph simple and the maximum degree exact, and ForceAtlas2
+// follows the changing graph without being rebuilt.
+void testGrowthUnderForceAtlas2()
+{
+	std::mt19937 engine(51);
+	GeneratorParams generator;
+	std::vector<Node> nodes;
+	generateNodes(engine, nodes, 20, generator.mRadiusMean, generator.mRadiusStd);
+	std::vector<Edge> edges;
+	for (auto i = 1; i < 20; ++i)
+	{
+		edges.push_back(Edge{i, i - 1, 1.0f, 0.05f});
+	}
+
+	DynamicGraph graph;
+	graph.assign(edges, nodes.size());
+	GraphGrowth growth;
+	growth.reset(engine, graph);
+	ForceAtlas2 forceAtlas2;
+	forceAtlas2.reset(nodes.size());
+
+	GrowthParams params;
+	params.mNodesPerStep = 1.5f;
+	params.mEdgesPerNode = 3;
+	params.mMaxNodes = 400;
+	params.mRewiresPerStep = 0.5f;
+	params.mChurnPerStep = 0.5f;
+	for (auto step = 0; step < 300; ++step)
+	{
+		auto delta = growth.step(nodes, graph, params, generator);
+		CHECK(graph.numNodes() == static_cast<int>(nodes.size()));
+		CHECK(graph.numEdges() == edges.size());
+		if (delta.mAddedNodes > 0)
+		{
+			forceAtlas2.resize(nodes.size());
+		}
+		forceAtlas2.step(nodes, graph, ForceAtlas2Params());
+
+		auto degrees = degreeSequence(nodes.size(), edges);
+		CHECK(growth.maxDegree() == *std::max_element(degrees.begin(), degrees.end()));
+	}
+	CHECK(nodes.size() == 400);
+
+	std::vector<std::uint64_t> keys;
+	for (const auto &edge : edges)
+	{
+		CHECK(edge.mHead != edge.mTail);
+		keys.push_back(edgeKey(edge.mHead, edge.mTail));
+	}
+	std::sort(keys.begin(), keys.end());
+	CHECK(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+	for (const auto &node : nodes)
+	{
+		CHECK(std::isfinite(node.mPosition.x) && std::isfinite(node.mPosition.y) && std::isfinite(node.mPosition.z));
+	}
+}
+
+int main()
+{
+	testGrowthUnderForceAtlas2();
+	return checkResult();
+}
@@ -0,0 +1,156 @@
+#include "check.hpp"
+#include "graph_import.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+void writeFile(const std::string &path, const std::string &text)
+{
+	std::ofstream stream(path, std::ios::binary);
+	stream << text;
+}
+
+template <typename Import>
+bool throwsOnImport(Import import)
+{
+	try
+	{
+		import();
+	}
+	catch (const std::runtime_error &)
+	{
+		return true;
+	}
+	return false;
+}
+
+bool sameEndpoints(const std::vector<Edge> &edges, const std::vector<std::pair<int, int>> &expected)
+{
+	if (edges.size() != expected.size())
+	{
+		return false;
+	}
+	for (std::size_t i = 0; i < edges.size(); ++i)
+	{
+		if (edges[i].mHead != expected[i].first || edges[i].mTail != expected[i].second)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+// Weights are optional per line, comments and blank lines are skipped and CRLF endings are accepted.
+void testEdgeList()
+{
+	auto path = temporaryPath("edges.txt");
+	writeFile(path, "# comment\r\n% another\r\n0 1\r\n\r\n  2\t3 0.5\r\n4 2 1e-1 # trailing\r\n1 0");
+	auto graph = importEdgeList(path);
+	CHECK(graph.mNumNodes == 5);
+	CHECK(sameEndpoints(graph.mEdges, {{0, 1}, {2, 3}, {4, 2}, {1, 0}}));
+	CHECK(std::isnan(graph.mEdges[0].mWeight) && std::isnan(graph.mEdges[3].mWeight));
+	CHECK(graph.mEdges[1].mWeight == 0.5f && graph.mEdges[2].mWeight == 0.1f);
+	std::remove(path.c_str());
+}
+
+// Chunks split the file at byte offsets and then move to the next newline, so every line is parsed by
+// exactly one thread whatever the thread count.
+void testChunkBoundaries()
+{
+	std::string text;
+	std::vector<std::pair<int, int>> expected;
+	auto numNodes = 0;
+	for (auto i = 0; i < 500; ++i)
+	{
+		auto head = i * 7919 % 1000;
+		auto tail = i * 104729 % 100000;
+		text += std::to_string(head) + (i % 3 == 0 ? "\t" : "   ") + std::to_string(tail) + (i % 5 == 0 ? " 2.5" : "") + (i % 4 == 0 ? "\r\n" : "\n");
+		if (i % 50 == 0)
+		{
+			text += "# comment line\n";
+		}
+		expected.emplace_back(head, tail);
+		numNodes = std::max(numNodes, std::max(head, tail) + 1);
+	}
+	auto path = temporaryPath("chunks.txt");
+	writeFile(path, text);
+	for (auto threads : {1, 2, 3, 7, 16, 61})
+	{
+		auto graph = importEdgeList(path, threads);
+		CHECK(sameEndpoints(graph.mEdges, expected));
+		CHECK(graph.mNumNodes == numNodes);
+		auto weighted = 0;
+		for (const auto &edge : graph.mEdges)
+		{
+			weighted += edge.mWeight == 2.5f;
+		}
+		CHECK(weighted == 100);
+	}
+	std::remove(path.c_str());
+}
+
+// A malformed line anywhere fails the whole import, as does a weight that is not a finite number.
+void testMalformedEdgeLists()
+{
+	auto path = temporaryPath("malformed.txt");
+	for (auto text : {"0 1\n1 x\n", "0 1\n-1 2\n", "0\n", "0 1 abc\n", "0 1 inf\n", "0 1 nan\n", "0 99999999999\n"})
+	{
+		writeFile(path, text);
+		CHECK(throwsOnImport([&] { importEdgeList(path, 2); }));
+	}
+	CHECK(throwsOnImport([] { importEdgeList(temporaryPath("missing.txt")); }));
+	std::remove(path.c_str());
+}
+
+// Node ids map to indices in order of first appearance; only the <data> whose key is named "weight"
+// sets the weight, whatever its id.
+void testGraphML()
+{
+	auto path = temporaryPath("graph.graphml");
+	writeFile(path, "<?xml version=\"1.0\"?>\n"
+					"<graphml>\n"
+					"<key id=\"d0\" for=\"edge\" attr.name=\"length\" attr.type=\"float\"/>\n"
+					"<key id=\"d1\" for=\"edge\" attr.name=\"weight\" attr.type=\"float\"/>\n"
+					"<graph edgedefault=\"undirected\">\n"
+					"<node id=\"a\"/>\r\n<node id='b'/>\n<node id=\"c\"></node>\n"
+					"<edge source=\"a\" target=\"b\"><data key=\"d0\">9</data><data key=\"d1\"> 0.25 </data></edge>\n"
+					"<edge source=\"c\" target=\"a\"/>\n"
+					"<edge source=\"b\" target=\"d\"><data key=\"d0\">3</data></edge>\n"
+					"</graph>\n</graphml>\n");
+	auto graph = importGraphML(path);
+	CHECK(graph.mNumNodes == 4);
+	CHECK(sameEndpoints(graph.mEdges, {{0, 1}, {2, 0}, {1, 3}}));
+	CHECK(graph.mEdges[0].mWeight == 0.25f);
+	CHECK(std::isnan(graph.mEdges[1].mWeight) && std::isnan(graph.mEdges[2].mWeight));
+
+	writeFile(path, "<graphml><key id=\"w\" for=\"edge\" attr.name=\"weight\"/><graph>"
+					"<edge source=\"a\" target=\"b\"><data key=\"w\">heavy</data></edge></graph></graphml>");
+	CHECK(throwsOnImport([&] { importGraphML(path); }));
+	std::remove(path.c_str());
+}
+
+// The first number on each line is a degree; the rest of the line and comment lines are ignored.
+void testDegreeSequence()
+{
+	auto path = temporaryPath("degrees.txt");
+	writeFile(path, "# degrees\r\n3 node a\r\n\r\n  0\n% skipped\n12\t7\n1");
+	CHECK((importDegreeSequence(path) == std::vector<int>{3, 0, 12, 1}));
+	for (auto text : {"3\n-1\n", "3\nx\n", "99999999999\n"})
+	{
+		writeFile(path, text);
+		CHECK(throwsOnImport([&] { importDegreeSequence(path); }));
+	}
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	testEdgeList();
+	testChunkBoundaries();
+	testMalformedEdgeLists();
+	testGraphML();
+	testDegreeSequence();
+	return checkResult();
+}
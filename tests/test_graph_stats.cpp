@@ -0,0 +1,161 @@
+#include "check.hpp"
+#include "graph_generator.hpp"
+#include "graph_stats.hpp"
+#include <cmath>
+#include <queue>
+
+namespace
+{
+std::vector<int> sequentialBfs(const CsrGraph &graph, int source)
+{
+	std::vector<int> distances(graph.numNodes(), -1);
+	std::queue<int> queue;
+	distances[source] = 0;
+	queue.push(source);
+	while (!queue.empty())
+	{
+		auto u = queue.front();
+		queue.pop();
+		for (auto v = graph.begin(u); v != graph.end(u); ++v)
+		{
+			if (distances[*v] < 0)
+			{
+				distances[*v] = distances[u] + 1;
+				queue.push(*v);
+			}
+		}
+	}
+	return distances;
+}
+
+template <typename Generate>
+CsrGraph generate(int numNodes, unsigned seed, Generate streamEdges)
+{
+	std::mt19937 engine(seed);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(numNodes);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamEdges(context, nodes, stream);
+	return CsrGraph(numNodes, edges);
+}
+
+std::vector<CsrGraph> graphs()
+{
+	std::vector<CsrGraph> graphs;
+	for (unsigned seed = 1; seed <= 2; ++seed)
+	{
+		// Sparse enough to leave several components; the ring keeps many triangles.
+		graphs.push_back(generate(600, seed, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamErdosRenyi(context, nodes, 0.003f, stream); }));
+		graphs.push_back(generate(600, seed, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamErdosRenyi(context, nodes, 0.03f, stream); }));
+		graphs.push_back(generate(600, seed, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamWattsStrogatzRing(context, nodes, 8, 0.05f, stream); }));
+	}
+	return graphs;
+}
+
+bool adjacent(const CsrGraph &graph, int u, int v)
+{
+	return std::binary_search(graph.begin(u), graph.end(u), v);
+}
+
+bool near(double a, double b)
+{
+	return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+}
+}
+
+// Triangles through each node against a check of every neighbour pair.
+void testTriangles()
+{
+	for (const auto &graph : graphs())
+	{
+		auto triangles = countTriangles(graph);
+		for (auto u = 0; u < graph.numNodes(); ++u)
+		{
+			std::int64_t expected = 0;
+			for (auto v = graph.begin(u); v != graph.end(u); ++v)
+			{
+				for (auto w = v + 1; w != graph.end(u); ++w)
+				{
+					expected += adjacent(graph, *v, *w);
+				}
+			}
+			CHECK(triangles[u] == expected);
+		}
+	}
+}
+
+// With a path source per node the statistics are exact, so they must match a sequential BFS from
+// every node: mean distance over reachable pairs and the largest eccentricity as the diameter.
+void testExactStats()
+{
+	for (const auto &graph : graphs())
+	{
+		auto numNodes = graph.numNodes();
+		std::mt19937 engine(9);
+		auto stats = computeGraphStats(graph, numNodes, engine);
+
+		double distanceSum = 0;
+		std::int64_t numPairs = 0;
+		auto diameter = 0;
+		for (auto source = 0; source < numNodes; ++source)
+		{
+			for (auto distance : sequentialBfs(graph, source))
+			{
+				if (distance > 0)
+				{
+					distanceSum += distance;
+					++numPairs;
+					diameter = std::max(diameter, distance);
+				}
+			}
+		}
+		CHECK(stats.mNumPathSources == numNodes);
+		CHECK(near(stats.mAveragePathLength, distanceSum / numPairs));
+		CHECK(stats.mDiameter == diameter);
+
+		auto maxDegree = 0;
+		std::vector<std::size_t> histogram(numNodes, 0);
+		double closed = 0;
+		double triples = 0;
+		double local = 0;
+		auto triangles = countTriangles(graph);
+		for (auto u = 0; u < numNodes; ++u)
+		{
+			auto degree = graph.degree(u);
+			maxDegree = std::max(maxDegree, degree);
+			++histogram[degree];
+			auto pairs = degree * (degree - 1) / 2.0;
+			closed += triangles[u];
+			triples += pairs;
+			local += pairs > 0 ? triangles[u] / pairs : 0.0;
+		}
+		histogram.resize(maxDegree + 1);
+		CHECK(stats.mMaxDegree == maxDegree);
+		CHECK(stats.mDegreeHistogram == histogram);
+		CHECK(near(stats.mMeanDegree, static_cast<double>(graph.numArcs()) / numNodes));
+		CHECK(near(stats.mGlobalClustering, closed / triples));
+		CHECK(near(stats.mAverageClustering, local / numNodes));
+	}
+}
+
+// Sampled sources give a lower bound on the diameter and a path length close to the exact one.
+void testSampledStats()
+{
+	auto graph = generate(2000, 4, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamErdosRenyi(context, nodes, 0.005f, stream); });
+	std::mt19937 engine(10);
+	auto exact = computeGraphStats(graph, graph.numNodes(), engine);
+	auto sampled = computeGraphStats(graph, 128, engine);
+	CHECK(sampled.mNumPathSources == 128);
+	CHECK(sampled.mDiameter <= exact.mDiameter && sampled.mDiameter >= exact.mDiameter - 2);
+	CHECK(std::abs(sampled.mAveragePathLength - exact.mAveragePathLength) < 0.05 * exact.mAveragePathLength);
+}
+
+int main()
+{
+	testTriangles();
+	testExactStats();
+	testSampledStats();
+	return checkResult();
+}
@@ -0,0 +1,152 @@
+#include "check.hpp"
+#include "graph_generator.hpp"
+#include "multilevel_layout.hpp"
+#include <cmath>
+
+namespace
+{
+template <typename Generate>
+std::vector<Edge> generate(int numNodes, unsigned seed, Generate streamEdges)
+{
+	std::mt19937 engine(seed);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(numNodes);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamEdges(context, nodes, stream);
+	for (auto &edge : edges)
+	{
+		edge.mLength = 1.0f;
+	}
+	return edges;
+}
+
+// Sparse ER leaves isolated nodes and small trees, BA has hubs whose leaves cannot all be matched.
+std::vector<std::vector<Edge>> graphs(int numNodes)
+{
+	return {generate(numNodes, 1, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamErdosRenyi(context, nodes, 1.5f / nodes.size(), stream); }),
+			generate(numNodes, 2, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamBarabasiAlbert(context, nodes, 1, stream); }),
+			generate(numNodes, 3, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) { streamBarabasiAlbert(context, nodes, 3, stream); })};
+}
+
+// Sum of the stiffnesses between different groups, counting each undirected edge once.
+float crossingWeight(const LayoutLevel &level, const std::vector<int> &groups)
+{
+	auto weight = 0.0f;
+	for (auto u = 0; u < level.mNumNodes; ++u)
+	{
+		for (auto k = level.mOffsets[u]; k < level.mOffsets[u + 1]; ++k)
+		{
+			if (u < level.mNeighbors[k] && groups[u] != groups[level.mNeighbors[k]])
+			{
+				weight += level.mWeights[k];
+			}
+		}
+	}
+	return weight;
+}
+}
+
+// Every node gets a coarse node, every coarse node gets a child, and each group holds either one
+// node or nodes joined to another member of the group; mass and the stiffness between groups carry
+// over to the coarse level unchanged.
+void testCoarsening()
+{
+	const auto numNodes = 3000;
+	for (const auto &edges : graphs(numNodes))
+	{
+		std::mt19937 engine(4);
+		LayoutLevel level;
+		level.assign(numNodes, edges);
+		level.mMasses.assign(numNodes, 1.0f);
+		std::vector<int> original(numNodes);
+		std::iota(original.begin(), original.end(), 0);
+		for (auto round = 0; round < 4 && level.mNumNodes > 1; ++round)
+		{
+			auto coarse = coarsen(level, engine);
+			CHECK(coarse.mNumNodes < level.mNumNodes);
+			CHECK(static_cast<int>(level.mParents.size()) == level.mNumNodes);
+
+			std::vector<int> children(coarse.mNumNodes, 0);
+			std::vector<float> masses(coarse.mNumNodes, 0.0f);
+			auto mapped = true;
+			for (auto u = 0; u < level.mNumNodes; ++u)
+			{
+				auto parent = level.mParents[u];
+				mapped = mapped && parent >= 0 && parent < coarse.mNumNodes;
+				if (parent >= 0 && parent < coarse.mNumNodes)
+				{
+					++children[parent];
+					masses[parent] += level.mMasses[u];
+				}
+			}
+			CHECK(mapped);
+			CHECK(std::find(children.begin(), children.end(), 0) == children.end());
+			CHECK(masses == coarse.mMasses);
+
+			auto grouped = true;
+			for (auto u = 0; u < level.mNumNodes; ++u)
+			{
+				auto joined = children[level.mParents[u]] == 1;
+				for (auto k = level.mOffsets[u]; k < level.mOffsets[u + 1] && !joined; ++k)
+				{
+					joined = level.mParents[level.mNeighbors[k]] == level.mParents[u];
+				}
+				grouped = grouped && joined;
+			}
+			CHECK(grouped);
+			auto weight = std::accumulate(coarse.mWeights.begin(), coarse.mWeights.end(), 0.0f) / 2;
+			CHECK(std::abs(weight - crossingWeight(level, level.mParents)) <= 1e-3f * std::max(weight, 1.0f));
+
+			// Original nodes followed through every level still land on a coarse node.
+			for (auto &node : original)
+			{
+				node = level.mParents[node];
+				CHECK(node >= 0 && node < coarse.mNumNodes);
+			}
+			level = std::move(coarse);
+		}
+	}
+}
+
+// The layout returns a finite position for every node, isolated ones included, and pulls neighbours
+// closer together than nodes picked at random (by far on the trees, by less on the denser BA graph,
+// whose neighbourhoods grow too fast to embed compactly in three dimensions).
+void testLayout()
+{
+	const auto numNodes = 2000;
+	for (const auto &edges : graphs(numNodes))
+	{
+		std::mt19937 engine(5);
+		MultilevelParams params;
+		params.mIterations = 60;
+		auto positions = multilevelLayout(numNodes, edges, params, engine);
+		CHECK(static_cast<int>(positions.size()) == numNodes);
+		auto finite = true;
+		for (const auto &position : positions)
+		{
+			finite = finite && std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z);
+		}
+		CHECK(finite);
+
+		double edgeLength = 0;
+		for (const auto &edge : edges)
+		{
+			edgeLength += positions[edge.mHead].distance(positions[edge.mTail]);
+		}
+		double randomLength = 0;
+		for (auto i = 0; i < numNodes; ++i)
+		{
+			randomLength += positions[i].distance(positions[(i * 7919 + 13) % numNodes]);
+		}
+		CHECK(edgeLength / edges.size() < 0.75 * randomLength / numNodes);
+	}
+}
+
+int main()
+{
+	testCoarsening();
+	testLayout();
+	return checkResult();
+}
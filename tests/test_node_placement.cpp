@@ -0,0 +1,128 @@
+#include "check.hpp"
+#include "node_placement.hpp"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+NodePositions place(unsigned seed, std::size_t numNodes, NodePlacement mode, int threads)
+{
+	std::mt19937 engine(seed);
+	NodePositions positions;
+	placeNodes(engine, positions, numNodes, 100.0f, 10.0f, mode, threads);
+	return positions;
+}
+
+bool samePositions(const NodePositions &a, const NodePositions &b)
+{
+	return a.mX == b.mX && a.mY == b.mY && a.mZ == b.mZ;
+}
+}
+
+// Node i depends only on the key and i, so thread counts and ranges that cut through blocks give the
+// same positions bit for bit.
+void testThreadIndependence()
+{
+	const std::size_t numNodes = 10000 + 37;
+	for (auto mode : {NodePlacement::Angles, NodePlacement::UniformSphere})
+	{
+		auto reference = place(3, numNodes, mode, 1);
+		for (auto threads : {2, 3, 8, 64})
+		{
+			CHECK(samePositions(place(3, numNodes, mode, threads), reference));
+		}
+
+		std::mt19937 engine(3);
+		auto key = placement::key(engine);
+		NodePositions split;
+		split.mX.resize(numNodes);
+		split.mY.resize(numNodes);
+		split.mZ.resize(numNodes);
+		for (std::size_t first = 0, count = 1; first < numNodes; first += count, count = count * 3 + 5)
+		{
+			count = std::min(count, numNodes - first);
+			placeNodes(key, first, count, 100.0f, 10.0f, mode, split.mX.data() + first, split.mY.data() + first, split.mZ.data() + first);
+		}
+		CHECK(samePositions(split, reference));
+	}
+	CHECK(!samePositions(place(3, 1000, NodePlacement::Angles, 1), place(4, 1000, NodePlacement::Angles, 1)));
+}
+
+// The branch-free helpers against <cmath> over the inputs placeNodes gives them, and beyond.
+void testMathAccuracy()
+{
+	auto logError = 0.0;
+	auto sqrtError = 0.0;
+	for (std::uint32_t bits = 0; bits < (1u << 24); bits += 251)
+	{
+		auto u = placement::uniform(bits << 8);
+		CHECK(u > 0.0f && u <= 1.0f);
+		logError = std::max(logError, std::abs(placement::log(u) - std::log(static_cast<double>(u))));
+		auto x = -2.0f * placement::log(u);
+		sqrtError = std::max(sqrtError, std::abs(placement::sqrt(x) - std::sqrt(static_cast<double>(x))) / std::max(std::sqrt(static_cast<double>(x)), 1e-30));
+	}
+	CHECK(logError < 2e-6);
+	CHECK(sqrtError < 1e-6);
+	CHECK(placement::uniform(0) > 0.0f && placement::uniform(0xffffffffu) == 1.0f);
+
+	for (auto x : {std::numeric_limits<float>::min(), 1e-20f, 0.3f, 0.70710678f, 1.0f, 1.41421356f, 2.0f, 1e20f, std::numeric_limits<float>::max()})
+	{
+		CHECK(std::abs(placement::log(x) - std::log(static_cast<double>(x))) <= 4e-7 * std::max(1.0, std::abs(std::log(static_cast<double>(x)))));
+		CHECK(std::abs(placement::sqrt(x) - std::sqrt(static_cast<double>(x))) <= 1e-6 * std::sqrt(static_cast<double>(x)));
+	}
+	CHECK(placement::sqrt(0.0f) < 1e-18f && placement::sqrt(-0.0f) < 1e-18f);
+
+	auto sinError = 0.0;
+	auto cosError = 0.0;
+	for (auto i = -50000; i <= 50000; ++i)
+	{
+		auto t = 0.5f * i / 50000;
+		float sine;
+		float cosine;
+		placement::sinCosTurns(t, sine, cosine);
+		auto angle = 6.283185307179586 * t;
+		sinError = std::max(sinError, std::abs(sine - std::sin(angle)));
+		cosError = std::max(cosError, std::abs(cosine - std::cos(angle)));
+	}
+	CHECK(sinError < 1e-6);
+	CHECK(cosError < 1e-6);
+}
+
+// Radii follow the requested normal distribution, and the uniform-sphere mode has mean z near zero
+// with |z| / r uniform on [0, 1].
+void testDistribution()
+{
+	const std::size_t numNodes = 200000;
+	for (auto mode : {NodePlacement::Angles, NodePlacement::UniformSphere})
+	{
+		auto positions = place(5, numNodes, mode, 4);
+		double sum = 0;
+		double squares = 0;
+		double height = 0;
+		double absoluteHeight = 0;
+		for (std::size_t i = 0; i < numNodes; ++i)
+		{
+			auto radius = std::sqrt(static_cast<double>(positions.mX[i]) * positions.mX[i] + static_cast<double>(positions.mY[i]) * positions.mY[i] + static_cast<double>(positions.mZ[i]) * positions.mZ[i]);
+			sum += radius;
+			squares += radius * radius;
+			height += positions.mZ[i] / radius;
+			absoluteHeight += std::abs(positions.mZ[i]) / radius;
+		}
+		auto mean = sum / numNodes;
+		CHECK(std::abs(mean - 100.0) < 0.1);
+		CHECK(std::abs(std::sqrt(squares / numNodes - mean * mean) - 10.0) < 0.1);
+		CHECK(std::abs(height / numNodes) < 0.01);
+		if (mode == NodePlacement::UniformSphere)
+		{
+			CHECK(std::abs(absoluteHeight / numNodes - 0.5) < 0.01);
+		}
+	}
+}
+
+int main()
+{
+	testThreadIndependence();
+	testMathAccuracy();
+	testDistribution();
+	return checkResult();
+}
@@ -0,0 +1,142 @@
+#include "check.hpp"
+#include "graph_generator.hpp"
+
+namespace
+{
+std::vector<Node> placeNodes(int numNodes, unsigned seed)
+{
+	std::mt19937 engine(seed);
+	std::uniform_real_distribution<float> coordinate(-50, 50);
+	std::vector<Node> nodes(numNodes);
+	for (auto &node : nodes)
+	{
+		node.mPosition = ofVec3f(coordinate(engine), coordinate(engine), coordinate(engine));
+	}
+	return nodes;
+}
+
+std::vector<std::uint64_t> generatedKeys(const std::vector<Node> &nodes, const GeometricParams &params)
+{
+	std::mt19937 engine(1);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 1000);
+	streamRandomGeometric(context, nodes, params, stream);
+
+	std::vector<std::uint64_t> keys;
+	for (const auto &edge : edges)
+	{
+		CHECK(edge.mLength == nodes[edge.mHead].mPosition.distance(nodes[edge.mTail].mPosition));
+		keys.push_back(edgeKey(edge.mHead, edge.mTail));
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+// All pairs closer than the radius, with the same torus as the generator: mPeriod, or the cube the
+// default placement fills, widened when the nodes reach beyond it.
+std::vector<std::uint64_t> bruteForceKeys(const std::vector<Node> &nodes, const GeometricParams &params)
+{
+	ofVec3f low = nodes[0].mPosition;
+	auto extent = 0.0f;
+	for (const auto &node : nodes)
+	{
+		for (auto axis = 0; axis < 3; ++axis)
+		{
+			low[axis] = std::min(low[axis], node.mPosition[axis]);
+		}
+	}
+	for (const auto &node : nodes)
+	{
+		for (auto axis = 0; axis < 3; ++axis)
+		{
+			extent = std::max(extent, node.mPosition[axis] - low[axis]);
+		}
+	}
+	auto period = params.mPeriod > 0 ? params.mPeriod : 2 * (GeneratorParams().mRadiusMean + 3 * GeneratorParams().mRadiusStd);
+	auto side = std::max(period > extent ? period : extent + params.mRadius, params.mRadius);
+
+	std::vector<std::uint64_t> keys;
+	for (std::size_t i = 0; i < nodes.size(); ++i)
+	{
+		for (auto j = i + 1; j < nodes.size(); ++j)
+		{
+			auto delta = (nodes[j].mPosition - low) - (nodes[i].mPosition - low);
+			if (params.mPeriodic)
+			{
+				for (auto axis = 0; axis < 3; ++axis)
+				{
+					delta[axis] += delta[axis] > side / 2 ? -side : delta[axis] < -side / 2 ? side : 0.0f;
+				}
+			}
+			if (delta.lengthSquared() < params.mRadius * params.mRadius)
+			{
+				keys.push_back(edgeKey(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j)));
+			}
+		}
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+}
+
+void testAgainstBruteForce()
+{
+	auto nodes = placeNodes(800, 21);
+	// Open, then periodic with the derived cube, the exact torus the nodes fill, and a period below
+	// their extent.
+	for (auto period : {-1.0f, 0.0f, 100.0f, 60.0f})
+	{
+		// Radii below, near and above the cell count boundaries, including one larger than the cube.
+		for (auto radius : {3.0f, 7.5f, 26.0f, 40.0f, 150.0f})
+		{
+			GeometricParams params;
+			params.mRadius = radius;
+			params.mPeriodic = period >= 0;
+			params.mPeriod = std::max(period, 0.0f);
+			auto generated = generatedKeys(nodes, params);
+			CHECK(generated == bruteForceKeys(nodes, params));
+			CHECK(std::adjacent_find(generated.begin(), generated.end()) == generated.end());
+		}
+	}
+}
+
+// The two nodes that set the extent sit on opposite faces of their bounding cube; they must not wrap
+// onto each other. Nodes a small gap apart across the seam of a given period still join.
+void testPeriodicSeam()
+{
+	std::vector<Node> nodes = {Node{ofVec3f(0, 0, 0)}, Node{ofVec3f(100, 0, 0)}, Node{ofVec3f(50, 0, 0)}};
+	GeometricParams params;
+	params.mPeriodic = true;
+	params.mRadius = 10;
+	CHECK(generatedKeys(nodes, params).empty());
+	params.mPeriod = 100;
+	CHECK(generatedKeys(nodes, params).empty());
+
+	params.mPeriod = 104;
+	CHECK((generatedKeys(nodes, params) == std::vector<std::uint64_t>{edgeKey(0, 1)}));
+	params.mPeriodic = false;
+	CHECK(generatedKeys(nodes, params).empty());
+}
+
+void testDegenerateInputs()
+{
+	GeometricParams params;
+	CHECK(generatedKeys(placeNodes(1, 22), params).empty());
+	params.mRadius = 0;
+	CHECK(generatedKeys(placeNodes(100, 23), params).empty());
+
+	// Coincident nodes are all joined.
+	std::vector<Node> nodes(20, Node{ofVec3f(1, 2, 3)});
+	params.mRadius = 1;
+	CHECK(generatedKeys(nodes, params).size() == 20 * 19 / 2);
+}
+
+int main()
+{
+	testAgainstBruteForce();
+	testDegenerateInputs();
+	testPeriodicSeam();
+	return checkResult();
+}
@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "spectral_layout.hpp"
+#include <cmath>
+
+namespace
+{
+void addRing(std::vector<Edge> &edges, int first, int size)
+{
+	for (auto i = 0; i < size; ++i)
+	{
+		edges.push_back(Edge{first + i, first + (i + 1) % size, 1.0f, 1.0f});
+	}
+}
+
+// x^T L x / x^T x for one axis of an embedding.
+double rayleighQuotient(const CsrGraph &graph, const std::vector<std::array<float, 3>> &embedding, int axis)
+{
+	double numerator = 0;
+	double denominator = 0;
+	for (auto u = 0; u < graph.numNodes(); ++u)
+	{
+		denominator += embedding[u][axis] * embedding[u][axis];
+		for (auto v = graph.begin(u); v != graph.end(u); ++v)
+		{
+			auto difference = embedding[u][axis] - embedding[*v][axis];
+			numerator += 0.5 * difference * difference;
+		}
+	}
+	return numerator / denominator;
+}
+}
+
+// On a ring the two smallest non-zero eigenvalues are both 2 - 2 cos(2 pi / n).
+void testRing()
+{
+	const auto size = 60;
+	std::vector<Edge> edges;
+	addRing(edges, 0, size);
+	CsrGraph graph(size, edges);
+	std::mt19937 engine(1);
+	auto embedding = spectralEmbedding(graph, 500, engine);
+	auto expected = 2 - 2 * std::cos(2 * M_PI / size);
+	CHECK(std::abs(rayleighQuotient(graph, embedding, 0) - expected) < 1e-3 * expected);
+	CHECK(std::abs(rayleighQuotient(graph, embedding, 1) - expected) < 1e-3 * expected);
+}
+
+// Each component large enough for the solver gets its own embedding, largest first; smaller ones are
+// left out. A single solve on the whole graph would spend its vectors on component indicators.
+void testComponents()
+{
+	std::vector<Edge> edges;
+	addRing(edges, 0, 40);
+	addRing(edges, 40, 100);
+	addRing(edges, 140, 5);
+	const auto numNodes = 150;
+	CsrGraph graph(numNodes, edges);
+	std::mt19937 engine(2);
+	auto embeddings = componentSpectralEmbeddings(graph, connectedComponents(numNodes, edges), 500, engine);
+
+	CHECK(embeddings.size() == 2);
+	if (embeddings.size() != 2)
+	{
+		return;
+	}
+	CHECK(embeddings[0].mNodes.size() == 100 && embeddings[0].mNodes.front() == 40);
+	CHECK(embeddings[1].mNodes.size() == 40 && embeddings[1].mNodes.front() == 0);
+	for (const auto &embedding : embeddings)
+	{
+		std::vector<Edge> local;
+		addRing(local, 0, static_cast<int>(embedding.mNodes.size()));
+		auto expected = 2 - 2 * std::cos(2 * M_PI / embedding.mNodes.size());
+		auto quotient = rayleighQuotient(CsrGraph(embedding.mNodes.size(), local), embedding.mPositions, 0);
+		CHECK(std::abs(quotient - expected) < 1e-3 * expected);
+	}
+}
+
+void testTinyGraph()
+{
+	std::vector<Edge> edges;
+	addRing(edges, 0, 5);
+	std::mt19937 engine(3);
+	CsrGraph graph(5, edges);
+	CHECK(componentSpectralEmbeddings(graph, connectedComponents(5, edges), 100, engine).empty());
+}
+
+int main()
+{
+	testRing();
+	testComponents();
+	testTinyGraph();
+	return checkResult();
+}
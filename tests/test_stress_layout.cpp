@@ -0,0 +1,144 @@
+#include "check.hpp"
+#include "graph_generator.hpp"
+#include "stress_layout.hpp"
+#include <cmath>
+#include <queue>
+
+namespace
+{
+// Full stress, sum over connected pairs of (|x_i - x_j| - d_ij)^2 / d_ij^2, from a BFS per node.
+double stress(const CsrGraph &graph, const std::vector<ofVec3f> &positions)
+{
+	auto numNodes = graph.numNodes();
+	double total = 0;
+	for (auto source = 0; source < numNodes; ++source)
+	{
+		std::vector<int> distances(numNodes, -1);
+		std::queue<int> queue;
+		distances[source] = 0;
+		queue.push(source);
+		while (!queue.empty())
+		{
+			auto u = queue.front();
+			queue.pop();
+			for (auto v = graph.begin(u); v != graph.end(u); ++v)
+			{
+				if (distances[*v] < 0)
+				{
+					distances[*v] = distances[u] + 1;
+					queue.push(*v);
+				}
+			}
+		}
+		for (auto j = source + 1; j < numNodes; ++j)
+		{
+			if (distances[j] > 0)
+			{
+				auto error = positions[source].distance(positions[j]) - distances[j];
+				total += error * error / (static_cast<double>(distances[j]) * distances[j]);
+			}
+		}
+	}
+	return total;
+}
+
+// A grid, a binary tree and a lightly rewired ring.
+std::vector<CsrGraph> graphs()
+{
+	std::vector<CsrGraph> graphs;
+	const auto width = 6;
+	std::vector<std::pair<int, int>> grid;
+	for (auto u = 0; u < width * width; ++u)
+	{
+		if (u % width + 1 < width)
+		{
+			grid.emplace_back(u, u + 1);
+		}
+		if (u + width < width * width)
+		{
+			grid.emplace_back(u, u + width);
+		}
+	}
+	graphs.emplace_back(width * width, grid);
+
+	std::vector<std::pair<int, int>> tree;
+	for (auto u = 1; u < 63; ++u)
+	{
+		tree.emplace_back(u, (u - 1) / 2);
+	}
+	graphs.emplace_back(63, tree);
+
+	std::mt19937 engine(3);
+	GeneratorContext context(engine, GeneratorParams());
+	std::vector<Node> nodes(60);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 4096);
+	streamWattsStrogatzRing(context, nodes, 4, 0.1f, stream);
+	graphs.emplace_back(60, edges);
+	return graphs;
+}
+
+std::vector<ofVec3f> layout(const CsrGraph &graph, int numPivots, int numIterations)
+{
+	std::mt19937 engine(1);
+	StressParams params;
+	params.mNumPivots = numPivots;
+	params.mIterations = numIterations;
+	params.mTolerance = 0;
+	return stressLayout(graph, params, engine);
+}
+}
+
+// With every node a pivot the sparse model is the full one, and each majorisation step must not raise
+// the stress. The same seed replays the same pivots and start, so k iterations extend k - 1.
+void testStressDecreases()
+{
+	for (const auto &graph : graphs())
+	{
+		auto previous = stress(graph, layout(graph, graph.numNodes(), 0));
+		auto first = previous;
+		for (auto iterations = 1; iterations <= 15; ++iterations)
+		{
+			auto current = stress(graph, layout(graph, graph.numNodes(), iterations));
+			CHECK(current <= previous * (1 + 1e-6));
+			previous = current;
+		}
+		CHECK(previous < 0.8 * first);
+	}
+}
+
+// With few pivots the far terms are approximated, but the full stress still falls well below the
+// pivot MDS start.
+void testSparsePivots()
+{
+	for (const auto &graph : graphs())
+	{
+		CHECK(stress(graph, layout(graph, 10, 40)) < 0.9 * stress(graph, layout(graph, 10, 0)));
+	}
+}
+
+// Components the pivots never reach from each other still get finite, distinct positions.
+void testDisconnected()
+{
+	CsrGraph graph(6, std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {3, 4}});
+	auto positions = layout(graph, 3, 50);
+	CHECK(positions.size() == 6);
+	for (std::size_t i = 0; i < positions.size(); ++i)
+	{
+		CHECK(std::isfinite(positions[i].x) && std::isfinite(positions[i].y) && std::isfinite(positions[i].z));
+		for (auto j = i + 1; j < positions.size(); ++j)
+		{
+			CHECK(positions[i].distance(positions[j]) > 1e-3f);
+		}
+	}
+	CHECK(std::abs(positions[0].distance(positions[1]) - 1.0f) < 0.2f);
+}
+
+int main()
+{
+	testStressDecreases();
+	testSparsePivots();
+	testDisconnected();
+	return checkResult();
+}
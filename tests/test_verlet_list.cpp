@@ -0,0 +1,97 @@
+#include "check.hpp"
+#include "verlet_list.hpp"
+#include <random>
+
+namespace
+{
+// Pairs (i, j), i != j, closer than radius by brute force, in the list's per-point order.
+std::vector<std::vector<int>> nearPairs(const std::vector<ofVec3f> &points, float radius)
+{
+	std::vector<std::vector<int>> pairs(points.size());
+	for (std::size_t i = 0; i < points.size(); ++i)
+	{
+		for (std::size_t j = 0; j < points.size(); ++j)
+		{
+			if (i != j && points[i].distance(points[j]) < radius)
+			{
+				pairs[i].push_back(static_cast<int>(j));
+			}
+		}
+	}
+	return pairs;
+}
+
+// Pairs closer than radius among the list's candidates.
+std::vector<std::vector<int>> listedPairs(const VerletList &list, const std::vector<ofVec3f> &points, float radius)
+{
+	std::vector<std::vector<int>> pairs(points.size());
+	for (std::size_t i = 0; i < points.size(); ++i)
+	{
+		for (auto k = list.begin(i); k != list.end(i); ++k)
+		{
+			auto j = list.neighbor(k);
+			if (points[i].distance(points[j]) < radius)
+			{
+				pairs[i].push_back(j);
+			}
+		}
+		std::sort(pairs[i].begin(), pairs[i].end());
+	}
+	return pairs;
+}
+}
+
+// While points drift, the reused lists still hold every pair within the radius, and they are rebuilt
+// only after some point has moved half the skin.
+void testDriftingPoints()
+{
+	const auto radius = 1.0f;
+	const auto skin = 0.5f;
+	std::mt19937 engine(5);
+	std::uniform_real_distribution<float> coordinate(0, 12);
+	std::uniform_real_distribution<float> step(-0.04f, 0.04f);
+	std::vector<ofVec3f> points(800);
+	for (auto &point : points)
+	{
+		point = ofVec3f(coordinate(engine), coordinate(engine), coordinate(engine));
+	}
+
+	VerletList list;
+	auto position = [&](std::size_t i) { return points[i]; };
+	CHECK(list.update(points.size(), radius, skin, position));
+	auto rebuilds = 0;
+	for (auto frame = 0; frame < 40; ++frame)
+	{
+		for (auto &point : points)
+		{
+			point += ofVec3f(step(engine), step(engine), step(engine));
+		}
+		rebuilds += list.update(points.size(), radius, skin, position);
+		CHECK(listedPairs(list, points, radius) == nearPairs(points, radius));
+	}
+	CHECK(rebuilds > 0 && rebuilds < 20);
+}
+
+void testInvalidation()
+{
+	std::vector<ofVec3f> points = {ofVec3f(0, 0, 0), ofVec3f(0.5f, 0, 0), ofVec3f(5, 0, 0)};
+	auto position = [&](std::size_t i) { return points[i]; };
+	VerletList list;
+	CHECK(list.update(points.size(), 1.0f, 0.2f, position));
+	CHECK(!list.update(points.size(), 1.0f, 0.2f, position));
+	CHECK(list.numPairs() == 1);
+	CHECK(list.update(points.size(), 2.0f, 0.2f, position));
+
+	points.push_back(ofVec3f(5.5f, 0, 0));
+	CHECK(list.update(points.size(), 2.0f, 0.2f, position));
+	CHECK(list.numPairs() == 2);
+	list.invalidate();
+	CHECK(list.update(points.size(), 2.0f, 0.2f, position));
+}
+
+int main()
+{
+	testDriftingPoints();
+	testInvalidation();
+	return checkResult();
+}
@@ -0,0 +1,313 @@
+// Headless ensemble generator. Only the math headers of openFrameworks are used, so this builds
+// and runs without a display or OpenGL.
+//
+// batch --type er|ba|ws|wsring|rmat|sbm|chunglu|config|rgg [--count N] [--nodes N] [--min X] [--max X] [--steps N] [--neighbors K]
+//       [--seed S] [--threads T] [--output DIR] [--format edges|graphml|gexf|dot|rgraph]
+//       [--radius-mean X] [--radius-std X] [--edge-weight-min X] [--edge-weight-max X]
+//       [--placement angles|sphere] [--blocks B] [--in-prob X] [--degrees FILE]
+//       [--periodic 0|1]
+//
+// The swept parameter is the edge probability (er), the edges per new node (ba), the rewiring
+// probability (ws on the spatial nearest-neighbour lattice, wsring on the index ring lattice) or the
+// edge factor (rmat, Graph500 quadrant probabilities), the between-block probability (sbm, B equal
+// blocks with in-block probability X) or a factor on the degrees read from FILE (chunglu as expected
+// degrees, config as exact degrees with loops and multi-edges erased; FILE sets the node count) or
+// the connection radius (rgg, optionally on the periodic bounding cube). One CSV line of summary
+// statistics per graph goes to stdout. DIR is created if missing. Jobs run on T threads, each
+// generating and writing its graph single-threaded.
+
+#include "csr_graph.hpp"
+#include "graph_export.hpp"
+#include "graph_file.hpp"
+#include "graph_generator.hpp"
+#include "graph_import.hpp"
+#include "parallel.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct BatchJob
+{
+	int mStep;
+	int mReplicate;
+	float mParam;
+};
+
+struct BatchResult
+{
+	std::size_t mNumEdges = 0;
+	double mMeanDegree = 0;
+	int mMaxDegree = 0;
+	int mNumIsolated = 0;
+	std::string mError;
+};
+
+int usage()
+{
+	std::fprintf(stderr, "usage: batch --type er|ba|ws|wsring|rmat|sbm|chunglu|config|rgg [--count N] [--nodes N] [--min X] [--max X] [--steps N] [--neighbors K]\n"
+						 "             [--seed S] [--threads T] [--output DIR] [--format edges|graphml|gexf|dot|rgraph]\n");
+	return 1;
+}
+
+int runBatch(std::unordered_map<std::string, std::string> &options);
+
+int main(int argc, char *argv[])
+{
+	std::unordered_map<std::string, std::string> options = {{"--type", ""},
+															{"--count", "1"},
+															{"--nodes", "100"},
+															{"--min", ""},
+															{"--max", ""},
+															{"--steps", "1"},
+															{"--neighbors", "10"},
+															{"--blocks", "4"},
+															{"--in-prob", "0.1"},
+															{"--degrees", ""},
+															{"--periodic", "0"},
+															{"--seed", "0"},
+															{"--threads", std::to_string(numThreads())},
+															{"--output", ""},
+															{"--format", "edges"},
+															{"--radius-mean", "100"},
+															{"--radius-std", "10"},
+															{"--edge-weight-min", "0"},
+															{"--edge-weight-max", "0.1"},
+															{"--placement", "angles"}};
+	for (auto i = 1; i < argc; i += 2)
+	{
+		if (!options.count(argv[i]) || i + 1 == argc)
+		{
+			return usage();
+		}
+		options[argv[i]] = argv[i + 1];
+	}
+
+	// Malformed or out-of-range numbers surface here from std::stoi and friends.
+	try
+	{
+		return runBatch(options);
+	}
+	catch (const std::invalid_argument &)
+	{
+		return usage();
+	}
+	catch (const std::out_of_range &)
+	{
+		return usage();
+	}
+}
+
+int runBatch(std::unordered_map<std::string, std::string> &options)
+{
+	auto type = options["--type"];
+	std::unordered_map<std::string, std::pair<float, float>> defaultRanges = {{"er", {0.05, 0.2}}, {"ba", {1, 10}}, {"ws", {0.01, 0.1}}, {"wsring", {0.01, 0.1}}, {"rmat", {4, 16}}, {"sbm", {0.001, 0.01}}, {"chunglu", {1, 1}}, {"config", {1, 1}}, {"rgg", {20, 40}}};
+	if (!defaultRanges.count(type))
+	{
+		return usage();
+	}
+	auto paramMin = options["--min"].empty() ? defaultRanges[type].first : std::stof(options["--min"]);
+	auto paramMax = options["--max"].empty() ? defaultRanges[type].second : std::stof(options["--max"]);
+	auto count = std::stoi(options["--count"]);
+	auto steps = std::max(1, std::stoi(options["--steps"]));
+	auto numNodes = std::stoi(options["--nodes"]);
+	auto numNeighbors = std::stoi(options["--neighbors"]);
+	auto numBlocks = std::stoi(options["--blocks"]);
+	auto inProb = std::stof(options["--in-prob"]);
+	auto periodic = std::stoi(options["--periodic"]) != 0;
+	auto threads = std::stoi(options["--threads"]);
+	if (count < 0 || numNodes < 0 || numNeighbors < 0 || numBlocks < 1 || threads < 1)
+	{
+		return usage();
+	}
+	std::vector<int> targetDegrees;
+	if (type == "chunglu" || type == "config")
+	{
+		if (options["--degrees"].empty())
+		{
+			return usage();
+		}
+		try
+		{
+			targetDegrees = importDegreeSequence(options["--degrees"]);
+		}
+		catch (const std::exception &error)
+		{
+			std::fprintf(stderr, "%s\n", error.what());
+			return 1;
+		}
+		numNodes = static_cast<int>(targetDegrees.size());
+	}
+	auto seed = static_cast<std::uint32_t>(std::stoul(options["--seed"]));
+	GeneratorParams params;
+	params.mRadiusMean = std::stof(options["--radius-mean"]);
+	params.mRadiusStd = std::stof(options["--radius-std"]);
+	params.mEdgeWeightMin = std::stof(options["--edge-weight-min"]);
+	params.mEdgeWeightMax = std::stof(options["--edge-weight-max"]);
+	params.mPlacement = options["--placement"] == "sphere" ? NodePlacement::UniformSphere : NodePlacement::Angles;
+	auto output = options["--output"];
+	auto format = options["--format"];
+	if (!output.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(output, error);
+		if (error)
+		{
+			std::fprintf(stderr, "cannot create %s: %s\n", output.c_str(), error.message().c_str());
+			return 1;
+		}
+	}
+
+	std::vector<BatchJob> jobs;
+	for (auto step = 0; step < steps; ++step)
+	{
+		auto param = steps == 1 ? paramMin : paramMin + (paramMax - paramMin) * step / (steps - 1);
+		for (auto replicate = 0; replicate < count; ++replicate)
+		{
+			jobs.push_back(BatchJob{step, replicate, param});
+		}
+	}
+
+	std::vector<BatchResult> results(jobs.size());
+	std::atomic<std::size_t> nextJob(0);
+	parallelRanges(threads, [&](int, std::size_t, std::size_t) {
+		ScopedThreadLimit limit(1);
+		std::vector<Node> nodes;
+		std::vector<Edge> edges;
+		std::vector<int> degrees;
+		for (auto index = nextJob++; index < jobs.size(); index = nextJob++)
+		{
+			const auto &job = jobs[index];
+			auto &result = results[index];
+
+			// Every graph gets an independent stream derived from (seed, step, replicate).
+			std::seed_seq sequence = {seed, static_cast<std::uint32_t>(job.mStep), static_cast<std::uint32_t>(job.mReplicate)};
+			std::mt19937 engine(sequence);
+			GeneratorContext context(engine, params);
+			context.placeNodes(nodes, numNodes);
+
+			// Without an output directory only degrees are kept, so edges never accumulate in memory.
+			edges.clear();
+			degrees.assign(numNodes, 0);
+			VectorEdgeSink vectorSink(edges);
+			CallbackEdgeSink degreeSink([&](const Edge *chunk, std::size_t size) {
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					++degrees[chunk[i].mHead];
+					++degrees[chunk[i].mTail];
+				}
+				result.mNumEdges += size;
+			});
+			EdgeStream stream(output.empty() ? static_cast<EdgeSink &>(degreeSink) : vectorSink, 1 << 16);
+
+			// Generators throw on parameters they cannot honour; the job fails, the batch goes on.
+			try
+			{
+				if (type == "er")
+				{
+					streamErdosRenyi(context, nodes, job.mParam, stream);
+				}
+				else if (type == "ba")
+				{
+					streamBarabasiAlbert(context, nodes, static_cast<int>(job.mParam + 0.5f), stream);
+				}
+				else if (type == "sbm")
+				{
+					auto sbmParams = plantedPartition(numNodes, numBlocks, inProb, job.mParam);
+					clusterBlocks(nodes, sbmParams.mBlockSizes, params.mRadiusMean, 0.25f);
+					streamStochasticBlockModel(context, nodes, sbmParams, stream);
+				}
+				else if (type == "rgg")
+				{
+					GeometricParams geometricParams;
+					geometricParams.mRadius = job.mParam;
+					geometricParams.mPeriodic = periodic;
+					streamRandomGeometric(context, nodes, geometricParams, stream);
+				}
+				else if (type == "chunglu")
+				{
+					std::vector<float> weights(numNodes);
+					for (auto i = 0; i < numNodes; ++i)
+					{
+						weights[i] = targetDegrees[i] * job.mParam;
+					}
+					streamChungLu(context, nodes, weights, stream);
+				}
+				else if (type == "config")
+				{
+					std::vector<int> scaled(numNodes);
+					for (auto i = 0; i < numNodes; ++i)
+					{
+						scaled[i] = static_cast<int>(std::lround(targetDegrees[i] * job.mParam));
+					}
+					streamConfigurationModel(context, nodes, scaled, true, stream);
+				}
+				else if (type == "rmat")
+				{
+					RmatParams rmatParams;
+					rmatParams.mEdgeFactor = static_cast<int>(job.mParam + 0.5f);
+					streamRmat(context, nodes, rmatParams, stream);
+				}
+				else if (type == "wsring")
+				{
+					streamWattsStrogatzRing(context, nodes, numNeighbors, job.mParam, stream);
+				}
+				else
+				{
+					streamWattsStrogatz(context, nodes, numNeighbors, job.mParam, stream);
+				}
+			}
+			catch (const std::exception &error)
+			{
+				result.mError = error.what();
+				continue;
+			}
+
+			if (!output.empty())
+			{
+				degreeSink.consume(edges.data(), edges.size());
+				auto path = output + "/" + type + "_" + std::to_string(job.mStep) + "_" + std::to_string(job.mReplicate) + "." + format;
+				try
+				{
+					if (format == "rgraph")
+					{
+						writeGraphFile(path, nodes, edges, CsrGraph(numNodes, edges));
+					}
+					else
+					{
+						exportGraph(path, nodes, edges);
+					}
+				}
+				catch (const std::exception &error)
+				{
+					result.mError = error.what();
+				}
+			}
+
+			for (auto degree : degrees)
+			{
+				result.mMaxDegree = std::max(result.mMaxDegree, degree);
+				result.mNumIsolated += degree == 0;
+			}
+			result.mMeanDegree = numNodes > 0 ? 2.0 * result.mNumEdges / numNodes : 0.0;
+		}
+	}, threads);
+
+	auto status = 0;
+	std::printf("type,step,replicate,param,nodes,edges,mean_degree,max_degree,isolated\n");
+	for (std::size_t i = 0; i < jobs.size(); ++i)
+	{
+		if (!results[i].mError.empty())
+		{
+			std::fprintf(stderr, "%s\n", results[i].mError.c_str());
+			status = 1;
+		}
+		std::printf("%s,%d,%d,%g,%d,%zu,%g,%d,%d\n", type.c_str(), jobs[i].mStep, jobs[i].mReplicate, jobs[i].mParam, numNodes,
+					results[i].mNumEdges, results[i].mMeanDegree, results[i].mMaxDegree, results[i].mNumIsolated);
+	}
+	return status;
+}
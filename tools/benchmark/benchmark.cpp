@@ -0,0 +1,293 @@
+// Generator and physics micro-benchmarks (Google Benchmark). Links against openFrameworks but never
+// opens a window. Track trends with:
+//
+//   benchmark --benchmark_format=json --benchmark_out=bench.json
+//
+// Every benchmark reports edges (or nodes) per second and the process peak RSS at the time it ran.
+
+#include "ofMain.h"
+#include "random_graph.hpp"
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+
+namespace
+{
+	double peakRssMegabytes()
+	{
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss / 1024.0;
+	}
+
+	void reportCounters(benchmark::State &state, std::size_t items, const char *name)
+	{
+		state.counters[name] = benchmark::Counter(static_cast<double>(items) * state.iterations(), benchmark::Counter::kIsRate);
+		state.counters["peak_rss_mb"] = peakRssMegabytes();
+	}
+
+	std::vector<Node> placeNodes(int numNodes)
+	{
+		std::mt19937 engine(numNodes);
+		std::vector<Node> nodes;
+		generateNodes(engine, nodes, numNodes, 100, 10);
+		return nodes;
+	}
+
+	// Power-law degrees with exponent 2.5 and minimum 2, the shape of most production graphs.
+	std::vector<int> powerLawDegrees(int numNodes)
+	{
+		std::mt19937 engine(numNodes);
+		std::uniform_real_distribution<double> uniform(0, 1);
+		std::vector<int> degrees(numNodes);
+		for (auto &degree : degrees)
+		{
+			degree = std::min(numNodes - 1, static_cast<int>(2 * std::pow(1 - uniform(engine), -1 / 1.5)));
+		}
+		return degrees;
+	}
+
+	// Generators stream into a counting sink so that only generation is measured, not edge storage.
+	template <typename Generate>
+	void benchmarkGenerator(benchmark::State &state, Generate generate)
+	{
+		auto nodes = placeNodes(state.range(0));
+		std::mt19937 engine(0);
+		GeneratorContext context(engine, GeneratorParams());
+		std::size_t numEdges = 0;
+		CallbackEdgeSink sink([&](const Edge *, std::size_t count) { numEdges += count; });
+		EdgeStream stream(sink, 1 << 16);
+
+		for (auto _ : state)
+		{
+			numEdges = 0;
+			generate(context, nodes, stream);
+			benchmark::DoNotOptimize(numEdges);
+		}
+		reportCounters(state, numEdges, "edges_per_second");
+	}
+
+	// The app is set up without a window and given a BA graph with about state.range(0) edges.
+	RandomGraph &physicsApp(int numEdges)
+	{
+		static RandomGraph app;
+		static auto initialised = false;
+		if (!initialised)
+		{
+			app.setupGraph();
+			initialised = true;
+		}
+		app.mNodes = placeNodes(std::max(numEdges / 5, 6));
+		app.mEdges.clear();
+		VectorEdgeSink sink(app.mEdges);
+		EdgeStream stream(sink, 1 << 16);
+		std::mt19937 engine(0);
+		GeneratorContext context(engine, GeneratorParams());
+		streamBarabasiAlbert(context, app.mNodes, 5, stream);
+		return app;
+	}
+}
+
+void BM_ErdosRenyi(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamErdosRenyi(context, nodes, 10.0f / nodes.size(), stream);
+	});
+}
+BENCHMARK(BM_ErdosRenyi)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+void BM_BarabasiAlbert(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamBarabasiAlbert(context, nodes, 5, stream);
+	});
+}
+BENCHMARK(BM_BarabasiAlbert)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+// The spatial k-NN lattice is O(n^2 log k), so sizes beyond 10^5 are left out.
+void BM_WattsStrogatz(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamWattsStrogatz(context, nodes, 10, 0.05, stream);
+	});
+}
+BENCHMARK(BM_WattsStrogatz)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+void BM_WattsStrogatzRing(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamWattsStrogatzRing(context, nodes, 10, 0.05, stream);
+	});
+}
+BENCHMARK(BM_WattsStrogatzRing)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+void BM_Rmat(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamRmat(context, nodes, RmatParams(), stream);
+	});
+}
+BENCHMARK(BM_Rmat)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Ten blocks with a mean degree of about 30, a fifth of it between blocks.
+void BM_StochasticBlockModel(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		auto numNodes = static_cast<float>(nodes.size());
+		streamStochasticBlockModel(context, nodes, plantedPartition(nodes.size(), 10, 240 / numNodes, 6.7f / numNodes), stream);
+	});
+}
+BENCHMARK(BM_StochasticBlockModel)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+void BM_ChungLu(benchmark::State &state)
+{
+	auto degrees = powerLawDegrees(state.range(0));
+	std::vector<float> weights(degrees.begin(), degrees.end());
+	benchmarkGenerator(state, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamChungLu(context, nodes, weights, stream);
+	});
+}
+BENCHMARK(BM_ChungLu)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+void BM_ConfigurationModel(benchmark::State &state)
+{
+	auto degrees = powerLawDegrees(state.range(0));
+	benchmarkGenerator(state, [&](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		streamConfigurationModel(context, nodes, degrees, true, stream);
+	});
+}
+BENCHMARK(BM_ConfigurationModel)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// The radius shrinks with the node count so the mean degree stays near 30.
+void BM_RandomGeometric(benchmark::State &state)
+{
+	benchmarkGenerator(state, [](GeneratorContext &context, const std::vector<Node> &nodes, EdgeStream &stream) {
+		GeometricParams params;
+		params.mRadius = 2.3f * std::cbrt(1e6f / nodes.size());
+		streamRandomGeometric(context, nodes, params, stream);
+	});
+}
+BENCHMARK(BM_RandomGeometric)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// One removal and one insertion of a random edge per iteration, through the dynamic index.
+void BM_DynamicGraph(benchmark::State &state)
+{
+	auto nodes = placeNodes(state.range(0) / 5);
+	std::vector<Edge> edges;
+	VectorEdgeSink sink(edges);
+	EdgeStream stream(sink, 1 << 16);
+	std::mt19937 engine(0);
+	GeneratorContext context(engine, GeneratorParams());
+	streamBarabasiAlbert(context, nodes, 5, stream);
+	DynamicGraph graph;
+	graph.assign(edges, nodes.size());
+	for (auto _ : state)
+	{
+		graph.removeEdge(graph.id(context.index(graph.numEdges())));
+		graph.addEdge(context.edge(nodes, context.index(nodes.size()), context.index(nodes.size())));
+	}
+	reportCounters(state, 2, "updates_per_second");
+}
+BENCHMARK(BM_DynamicGraph)->RangeMultiplier(10)->Range(1000, 10000000);
+
+void BM_GenerateNodes(benchmark::State &state)
+{
+	std::mt19937 engine(0);
+	std::vector<Node> nodes;
+	for (auto _ : state)
+	{
+		generateNodes(engine, nodes, state.range(0), 100, 10);
+		benchmark::DoNotOptimize(nodes.data());
+	}
+	reportCounters(state, state.range(0), "nodes_per_second");
+}
+BENCHMARK(BM_GenerateNodes)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+// Batch placement straight into SoA arrays, without the scatter into Node.
+void BM_PlaceNodes(benchmark::State &state)
+{
+	std::mt19937 engine(0);
+	NodePositions positions;
+	for (auto _ : state)
+	{
+		placeNodes(engine, positions, state.range(0), 100, 10, NodePlacement::UniformSphere);
+		benchmark::DoNotOptimize(positions.mX.data());
+	}
+	reportCounters(state, state.range(0), "nodes_per_second");
+}
+BENCHMARK(BM_PlaceNodes)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+// One full physics step (noise, springs, integration) at a given edge count.
+void BM_PhysicsStep(benchmark::State &state)
+{
+	auto &app = physicsApp(state.range(0));
+	for (auto _ : state)
+	{
+		app.updateNoise();
+		app.updateSprings();
+		app.updateNodes();
+		benchmark::ClobberMemory();
+	}
+	reportCounters(state, app.mEdges.size(), "edges_per_second");
+}
+BENCHMARK(BM_PhysicsStep)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+void BM_Springs(benchmark::State &state)
+{
+	auto &app = physicsApp(state.range(0));
+	for (auto _ : state)
+	{
+		app.updateSprings();
+		benchmark::ClobberMemory();
+	}
+	reportCounters(state, app.mEdges.size(), "edges_per_second");
+}
+BENCHMARK(BM_Springs)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+// Grid rebuild plus short-range repulsion, on the same graphs as BM_Springs for comparison.
+void BM_Collisions(benchmark::State &state)
+{
+	auto &app = physicsApp(state.range(0));
+	for (auto _ : state)
+	{
+		app.updateCollisions();
+		benchmark::ClobberMemory();
+	}
+	reportCounters(state, app.mNodes.size(), "nodes_per_second");
+}
+BENCHMARK(BM_Collisions)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+// Projection into mVertices, the buffer the shader reads, against a fixed viewport. Every node is
+// reprojected, as when the camera moves.
+void BM_UpdateVertices(benchmark::State &state)
+{
+	auto &app = physicsApp(state.range(0) * 5);
+	auto viewport = ofRectangle(0, 0, 1024, 768);
+	for (auto _ : state)
+	{
+		app.invalidateVertices();
+		app.updateVertices(viewport);
+		app.mDirtyVertices.clear();
+		benchmark::DoNotOptimize(app.mVertices.data());
+	}
+	reportCounters(state, app.mNodes.size(), "nodes_per_second");
+}
+BENCHMARK(BM_UpdateVertices)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// The same with a still camera and still nodes: only the sleep test runs and nothing is marked dirty.
+void BM_UpdateVerticesAsleep(benchmark::State &state)
+{
+	auto &app = physicsApp(state.range(0) * 5);
+	auto viewport = ofRectangle(0, 0, 1024, 768);
+	app.invalidateVertices();
+	app.updateVertices(viewport);
+	app.mDirtyVertices.clear();
+	for (auto _ : state)
+	{
+		app.updateVertices(viewport);
+		benchmark::DoNotOptimize(app.mVertices.data());
+	}
+	reportCounters(state, app.mNodes.size(), "nodes_per_second");
+}
+BENCHMARK(BM_UpdateVerticesAsleep)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();